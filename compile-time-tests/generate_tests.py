@@ -104,6 +104,31 @@ n4::run_manager::create()
 """)
 ,
 
+
+    "Material spec with unknown element"
+    :
+    ( "unknown element symbol"
+    , """
+constexpr auto spec = n4::material_spec_N("bad", 1.0, {{"H", 2}, {"Oxygen", 1}});
+""")
+,
+
+    "Material spec with fractions not adding up to 1"
+    :
+    ( "mass fractions must add up to 1"
+    , """
+constexpr auto spec = n4::material_spec_F("bad", 1.0, {{"H", 0.2}, {"O", 0.7}});
+""")
+,
+
+    "Material spec with repeated element"
+    :
+    ( "element appears more than once"
+    , """
+constexpr auto spec = n4::material_spec_N("bad", 1.0, {{"H", 1}, {"O", 1}, {"H", 1}});
+""")
+,
+
 }
 
 
@@ -6,6 +6,7 @@
 #include <QBBC.hh>
 
 #include <cstdlib>
+#include <memory>
 
 auto geometry() {
   // Envelope parameters
@@ -71,9 +72,17 @@ auto generator() {
 }
 
 
-auto run_action(G4double& e_sum, G4double& e_sum2) {
+// Energy deposited in the scoring volume. Each thread has its own, so in
+// multi-threaded mode every worker reports the dose of its share of the events.
+struct dose {
+  G4double e_sum{0}, e_sum2{0}, e_evt{0};
+};
+
+
+auto run_action(std::shared_ptr<dose> d) {
   return (new n4::run_action())
-    -> end([&] (auto run){
+    -> end([d] (auto run){
+         auto e_sum = d->e_sum, e_sum2 = d->e_sum2;
          auto n_events = run -> GetNumberOfEvent();
          if (n_events == 0) return;
 
@@ -99,30 +108,32 @@ auto run_action(G4double& e_sum, G4double& e_sum2) {
 }
 
 
-auto event_action(G4double& e_sum, G4double& e_sum2, G4double& e_evt) {
+auto event_action(std::shared_ptr<dose> d) {
   return (new n4::event_action())
-    -> begin([&] (auto) {e_evt = 0;})
-    ->   end([&] (auto) {e_sum += e_evt; e_sum2 += e_evt * e_evt;});
+    -> begin([d] (auto) {d->e_evt = 0;})
+    ->   end([d] (auto) {d->e_sum += d->e_evt; d->e_sum2 += d->e_evt * d->e_evt;});
 }
 
 
-auto stepping_action(G4double& e_evt) {
-  return new n4::stepping_action([&] (auto step) {
+auto stepping_action(std::shared_ptr<dose> d) {
+  return new n4::stepping_action([d] (auto step) {
     auto scoring_vol = n4::find_logical("Shape2");
     auto current_volume = step -> GetPreStepPoint() -> GetTouchableHandle() -> GetVolume() -> GetLogicalVolume();
 
     if (current_volume == scoring_vol) {
-      e_evt += step -> GetTotalEnergyDeposit();
+      d->e_evt += step -> GetTotalEnergyDeposit();
     }
   });
 }
 
 
-auto create_actions(G4double& e_sum, G4double& e_sum2, G4double& e_evt) {
+// Called once per thread
+n4::actions* create_actions() {
+  auto d = std::make_shared<dose>();
   return (new n4::actions{generator()})
-    -> set(     run_action(e_sum, e_sum2       ))
-    -> set(   event_action(e_sum, e_sum2, e_evt))
-    -> set(stepping_action(               e_evt));
+    -> set(     run_action(d))
+    -> set(   event_action(d))
+    -> set(stepping_action(d));
 }
 
 
@@ -134,7 +145,6 @@ int main(int argc, char* argv[]) {
   G4SteppingVerbose::UseBestUnit(precision);
 
   auto check_overlaps = false;
-  G4double e_sum{0}, e_sum2{0}, e_evt{0};
 
   if (check_overlaps) { n4::place::check_overlaps_switch_on(); }
 
@@ -143,6 +153,6 @@ int main(int argc, char* argv[]) {
     .macro_path("macs")
     .physics<QBBC>(0) // verbosity 0
     .geometry(geometry)
-    .actions(create_actions(e_sum, e_sum2, e_evt))
+    .actions(create_actions)
     .run();
 }
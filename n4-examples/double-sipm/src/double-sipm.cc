@@ -1,6 +1,7 @@
 #include "shared.hh"
 #include "generator.hh"
 #include "geometry.hh"
+#include "materials.hh"
 
 #include <n4-main.hh>
 #include <n4-inspect.hh>
@@ -18,6 +19,7 @@
 #include <G4Step.hh>
 #include <G4SubtractionSolid.hh>
 #include <G4SystemOfUnits.hh>
+#include <G4Threading.hh>
 #include <G4ThreeVector.hh>
 #include <G4Tubs.hh>
 
@@ -82,6 +84,7 @@ void gamma_interaction_z_pos(std::vector<std::vector<G4double>>& gamma_zs, G4Ste
 
 void open_files(output& output) {
   auto seed = std::to_string(G4Random::getTheSeed());
+  if (G4Threading::IsWorkerThread()) { seed += "_thread_" + std::to_string(G4Threading::G4GetThreadId()); }
   std::string dir{"output-double-sipm"};
   std::filesystem::create_directory(dir);
   output.gamma_z_data_files[0].open(dir + "/z_pos_0_seed_" + seed + ".csv");
@@ -163,16 +166,15 @@ auto actions(data& data, output& output) {
 }
 
 int main(int argc, char *argv[]) {
-  data     data;
-  output output;
+  define_materials();
 
   n4::run_manager::create()
     .ui("double-sipm", argc, argv)
     .macro_path("macs")
     .apply_cli_early() // CLI --early executed at this point
     .physics (physics_list)
-    .geometry([&]{ return make_geometry(data, config); })
-    .actions ([&]{ return actions(data, output); })
+    .geometry([&]{ return make_geometry(config); })
+    .actions ([&]{ return actions(data_of_this_thread(), output_of_this_thread()); })
     .apply_cli_late() // CLI --late executed at this point
     .run();
 }
@@ -28,16 +28,13 @@
 #include <G4Tubs.hh>
 #include <Randomize.hh>
 
-using vec_double = std::vector<G4double>;
-
-G4double detection_probability(G4double energy, const vec_double& energies, const vec_double& scintillation);
 void place_csi_teflon_border_surface_between(G4PVPlacement* one, G4PVPlacement* two);
-n4::sensitive_detector* sensitive_detector(G4int nb_detectors_per_side, data& data);
+n4::photodetector* sensitive_detector(G4int nb_detectors_per_side);
 
-G4PVPlacement* make_geometry(data& data, const config& config) {
+G4PVPlacement* make_geometry(const config& config) {
     auto csi     =    csi_with_properties(config);
-    auto air     =    air_with_properties();
-    auto teflon  = teflon_with_properties();
+    auto air     = n4::material("double-sipm-air");
+    auto teflon  = n4::material("double-sipm-teflon");
     auto plastic = n4::material("G4_POLYCARBONATE");
 
     auto world = n4::box{"World"}.cube(100*mm).volume(air);
@@ -69,7 +66,7 @@ G4PVPlacement* make_geometry(data& data, const config& config) {
     G4double sipm_width = scint_xy / n_sipms_per_axis; // assumes the detectors are square
     G4double sipm_depth = sipm_width;                  // this will make the sipms cubes
     auto sipm = n4::box{"Sipm"}.xy(sipm_width).z(sipm_depth)
-      .sensitive(sensitive_detector(n_sipms, data))
+      .sensitive(sensitive_detector(n_sipms))
       .volume(air); // material doesn't matter: everything entering the sipm is stopped immediately
 
     auto offset = -(n_sipms_per_axis - 1) * sipm_width / 2;
@@ -88,25 +85,20 @@ G4PVPlacement* make_geometry(data& data, const config& config) {
     return n4::place(world).now();
 }
 
-n4::sensitive_detector* sensitive_detector(G4int n_sipms, data& data) {
-  auto process_hits = [n_sipms, &data](G4Step* step) {
-    step -> GetTrack() -> SetTrackStatus(fStopAndKill);
-
-    auto pre           = step -> GetPreStepPoint();
-    auto copy_no       = pre  -> GetTouchable() -> GetCopyNumber();
-    auto time          = pre  -> GetGlobalTime()    / ns;
-    auto photon_energy = pre  -> GetKineticEnergy();
+n4::photodetector* sensitive_detector(G4int n_sipms) {
+  auto sipm_energies = n4::const_over(c4::hc/nm, { 900, 700,   500,   460,  400,  360,  340,  300,  280});
+  std::vector<G4double> sipm_pdes =              {0.03, 0.1, 0.245, 0.255, 0.23, 0.18, 0.18, 0.14, 0.02};
 
-    auto sipm_energies = n4::const_over(c4::hc/nm, { 900, 700,   500,   460,  400,  360,  340,  300,  280});
-    std::vector<G4double> sipm_pdes =              {0.03, 0.1, 0.245, 0.255, 0.23, 0.18, 0.18, 0.14, 0.02};
-
-    if (n4::random::uniform() < detection_probability(photon_energy, sipm_energies, sipm_pdes)) {
-      auto side = copy_no < n_sipms ? 0 : 1;
-      data.times_of_arrival[side].push_back(time);
+  // Called by the copy of the detector in each worker thread
+  auto record_arrival_times = [n_sipms] (auto const& hits) {
+    auto& data = data_of_this_thread();
+    for (auto const& hit : hits) {
+      auto side = hit.copy_no < n_sipms ? 0 : 1;
+      data.times_of_arrival[side].push_back(hit.time / ns);
     }
-    return true; // See https://jacg.github.io/nain4/explanation/process-hits-return-value.html
   };
-  return new n4::sensitive_detector{"Detector", process_hits};
+  return (new n4::photodetector{"Detector", sipm_energies, sipm_pdes})
+    -> end_of_event(record_arrival_times);
 }
 
 void place_csi_teflon_border_surface_between(G4PVPlacement* one, G4PVPlacement* two) {
@@ -132,20 +124,3 @@ void place_csi_teflon_border_surface_between(G4PVPlacement* one, G4PVPlacement*
     }
     new G4LogicalBorderSurface(name, one, two, csi_teflon_surface);
 }
-
-G4double detection_probability(G4double energy, const vec_double& energies, const vec_double& scintillation) {
-    // Detection probablity = 0 if energy lies outside of range
-    if (! (energies.front() <= energy && energy <= energies.back())) { return 0; }
-
-    // Find index of first point above desired energy
-    size_t index = 0;
-    for (size_t i=1; i<energies.size(); i++) {
-        if (energy < energies[i]) {
-            index = i;
-            break;
-        }
-    }
-    G4double y0 = scintillation[index-1]; G4double y1 = scintillation[index];
-    G4double x0 = energies     [index-1]; G4double x1 = energies     [index];
-    return y0 + (y1 - y0) / (x1 - x0) * (energy - x0);
-}
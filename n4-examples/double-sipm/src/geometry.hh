@@ -3,4 +3,4 @@
 #include "shared.hh"
 #include <G4PVPlacement.hh>
 
-G4PVPlacement* make_geometry(data& data, const config& config);
+G4PVPlacement* make_geometry(const config& config);
@@ -47,22 +47,25 @@ G4Material* csi_with_properties(const config& config) {
     return csi;
 }
 
-G4Material* air_with_properties() {
-  static G4Material* air = nullptr;
-  if (!air) {
-    air = n4::material("G4_AIR");
+// A copy of a NIST material under a name of our own, so that adding optical
+// properties does not change what n4::material returns for the NIST name
+G4Material* copy_of(G4String const& nist_name, G4String const& name) {
+  auto nist = n4::material(nist_name);
+  return new G4Material{name, nist -> GetDensity(), nist, nist -> GetState(), nist -> GetTemperature(), nist -> GetPressure()};
+}
+
+void define_materials() {
+  n4::define_material("double-sipm-air", [] {
+    auto air = copy_of("G4_AIR", "double-sipm-air");
     auto mpt = n4::material_properties()
       .add("RINDEX", OPTPHOT_ENERGY_RANGE, 1)
       .done();
     air -> SetMaterialPropertiesTable(mpt);
-  }
-  return air;
-}
+    return air;
+  });
 
-G4Material* teflon_with_properties() {
-  static G4Material* teflon = nullptr;
-  if (!teflon) {
-    teflon = n4::material("G4_TEFLON");
+  n4::define_material("double-sipm-teflon", [] {
+    auto teflon = copy_of("G4_TEFLON", "double-sipm-teflon");
     // Values could be taken from "Optical properties of Teflon AF
     // amorphous fluoropolymers" by Yang, French & Tokarsky (using
     // AF2400, Fig.6) but are also stated in the same paper as above
@@ -70,6 +73,6 @@ G4Material* teflon_with_properties() {
       .add("RINDEX", OPTPHOT_ENERGY_RANGE, 1.35)
       .done();
     teflon -> SetMaterialPropertiesTable(mpt);
-  }
-  return teflon;
+    return teflon;
+  });
 }
@@ -4,6 +4,8 @@
 
 #include <G4Material.hh>
 
-G4Material*    csi_with_properties(const config& config);
-G4Material*    air_with_properties();
-G4Material* teflon_with_properties();
+G4Material* csi_with_properties(const config& config);
+
+// Defines "double-sipm-air" and "double-sipm-teflon" for n4::material: call
+// it in main, before building the geometry
+void define_materials();
@@ -28,3 +28,6 @@ config::config() : msngr{new G4GenericMessenger{this, "/my/", "MY configuration
 void config::set_random_seed(G4long seed) { G4Random::setTheSeed(seed); }
 
 G4bool config::debug = false;
+
+data  &   data_of_this_thread() { thread_local data   data;   return data;   }
+output& output_of_this_thread() { thread_local output output; return output; }
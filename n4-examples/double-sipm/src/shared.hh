@@ -39,3 +39,7 @@ struct output {
   std::ofstream    time_data_files[2];
   std::ofstream    edep_data_files[2];
 };
+
+// Each worker thread collects and writes its events separately
+data  & data_of_this_thread();
+output& output_of_this_thread();
@@ -0,0 +1,95 @@
+#include <n4-mandatory.hh>
+#include <n4-telemetry.hh>
+
+#include <G4DynamicParticle.hh>
+#include <G4Event.hh>
+#include <G4Geantino.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Track.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+
+// Overhead of dispatching to user code through the n4 actions, compared with
+// a hand-written Geant4 action doing the same work. Geant4 calls the actions
+// through base class pointers, and so do these benchmarks. Each benchmark
+// makes `n_calls` calls.
+
+namespace {
+
+const size_t n_calls = 1000;
+
+size_t counter = 0;
+
+struct hand_written_stepping : G4UserSteppingAction {
+  void UserSteppingAction(G4Step const*) override { counter++; }
+};
+
+G4Track* geantino() {
+  auto particle = new G4DynamicParticle{G4Geantino::Definition(), G4ThreeVector{1, 0, 0}, 1*MeV};
+  return new G4Track{particle, 0, {}};
+}
+
+} // namespace
+
+TEST_CASE("action dispatch stepping", "[benchmark][actions]") {
+  G4Step step;
+  std::unique_ptr<G4UserSteppingAction> n4_action{new n4::stepping_action{[] (G4Step const*) { counter++; }}};
+  std::unique_ptr<G4UserSteppingAction> g4_action{new hand_written_stepping};
+
+  BENCHMARK("stepping, hand-written") {
+    for (size_t i=0; i<n_calls; i++) { g4_action -> UserSteppingAction(&step); }
+    return counter;
+  };
+
+  BENCHMARK("stepping, n4::stepping_action") {
+    for (size_t i=0; i<n_calls; i++) { n4_action -> UserSteppingAction(&step); }
+    return counter;
+  };
+}
+
+TEST_CASE("action dispatch tracking and stacking", "[benchmark][actions]") {
+  std::unique_ptr<G4Track> track{geantino()};
+  std::unique_ptr<G4UserTrackingAction> tracking{(new n4::tracking_action)
+    -> pre ([] (G4Track const*) { counter++; })
+    -> post([] (G4Track const*) { counter++; })};
+  std::unique_ptr<G4UserStackingAction> stacking{(new n4::stacking_action)
+    -> classify([] (G4Track const*) { counter++; return fUrgent; })};
+
+  BENCHMARK("tracking, n4::tracking_action pre and post") {
+    for (size_t i=0; i<n_calls; i++) {
+      tracking -> PreUserTrackingAction(track.get());
+      tracking -> PostUserTrackingAction(track.get());
+    }
+    return counter;
+  };
+
+  BENCHMARK("stacking, n4::stacking_action classify") {
+    size_t urgent = 0;
+    for (size_t i=0; i<n_calls; i++) { urgent += stacking -> ClassifyNewTrack(track.get()) == fUrgent; }
+    return urgent;
+  };
+}
+
+TEST_CASE("action dispatch event", "[benchmark][actions][telemetry]") {
+  G4Event event{0};
+  std::unique_ptr<G4UserEventAction> action{(new n4::event_action)
+    -> begin([] (G4Event const*) { counter++; })
+    -> end  ([] (G4Event const*) { counter++; })};
+
+  auto begin_and_end = [&] {
+    for (size_t i=0; i<n_calls; i++) {
+      action -> BeginOfEventAction(&event);
+      action ->   EndOfEventAction(&event);
+    }
+    return counter;
+  };
+
+  n4::telemetry::switch_off();
+  BENCHMARK("event, n4::event_action begin and end, telemetry off") { return begin_and_end(); };
+  n4::telemetry::switch_on();
+  BENCHMARK("event, n4::event_action begin and end, telemetry on" ) { return begin_and_end(); };
+}
@@ -0,0 +1,102 @@
+#include <n4-boolean-shape.hh>
+#include <n4-random.hh>
+#include <n4-sequences.hh>
+
+#include <G4SubtractionSolid.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+// A square plate perforated by a regular grid of holes, built in three ways:
+// + chained : one G4SubtractionSolid per hole (what repeated `.sub(...)` produces)
+// + multi   : a single subtraction of a voxelized G4MultiUnion of all the holes
+// + balanced: a single subtraction of a balanced tree of G4UnionSolids
+// The navigation cost is sampled with Inside and DistanceToIn at fixed points.
+
+namespace {
+
+const auto plate_side  = 1*m;
+const auto plate_thick = 1*cm;
+const auto hole_radius = 1*cm;
+
+std::vector<G4ThreeVector> hole_centres(unsigned n_side) {
+  auto pitch = plate_side / (n_side + 1);
+  auto first = -plate_side / 2 + pitch;
+  auto centres = n4::vec_with_capacity<G4ThreeVector>(n_side * n_side);
+  for   (unsigned i=0; i<n_side; i++) {
+    for (unsigned j=0; j<n_side; j++) {
+      centres.push_back({first + i*pitch, first + j*pitch, 0});
+    }
+  }
+  return centres;
+}
+
+G4VSolid* chained_plate(const std::vector<G4ThreeVector>& centres) {
+  auto hole = n4::tubs("hole").r(hole_radius).z(2*plate_thick).solid();
+  G4VSolid* plate = n4::box("plate").xy(plate_side).z(plate_thick).solid();
+  for (const auto& c : centres) {
+    plate = new G4SubtractionSolid{"plate", plate, hole, nullptr, c};
+  }
+  return plate;
+}
+
+G4VSolid* union_plate(const std::vector<G4ThreeVector>& centres, bool balanced) {
+  auto hole  = n4::tubs("hole").r(hole_radius).z(2*plate_thick);
+  auto holes = n4::multi_union("holes");
+  for (const auto& c : centres) { holes.add(hole).at(c); }
+  if (balanced) { holes.balanced(); }
+  return n4::box("plate").xy(plate_side).z(plate_thick).subtract_all(holes).solid();
+}
+
+// Fixed seed, so that every build samples the same points
+std::vector<G4ThreeVector> sample_points(size_t n) {
+  G4Random::setTheSeed(1234);
+  auto points = n4::vec_with_capacity<G4ThreeVector>(n);
+  for (size_t i=0; i<n; i++) {
+    points.push_back({ n4::random::uniform_width(plate_side)
+                     , n4::random::uniform_width(plate_side)
+                     , n4::random::uniform_width(plate_thick * 3) });
+  }
+  return points;
+}
+
+} // namespace
+
+TEST_CASE("boolean plate with holes navigation", "[benchmark][boolean][multi_union]") {
+  auto n_side  = GENERATE(4u, 10u, 20u);
+  auto centres = hole_centres(n_side);
+  auto points  = sample_points(1000);
+  auto down    = G4ThreeVector{0, 0, -1};
+  auto above   = [] (auto p) { return G4ThreeVector{p.x(), p.y(), plate_thick}; };
+
+  auto variants = std::vector<std::pair<std::string, G4VSolid*>>{
+    {"chained" , chained_plate(centres       )},
+    {"multi"   ,   union_plate(centres, false)},
+    {"balanced",   union_plate(centres, true )},
+  };
+
+  auto n_holes = std::to_string(centres.size());
+  for (auto& variant : variants) {
+    auto& label = variant.first;
+    auto  solid = variant.second;
+    // All variants must describe the same solid
+    for (const auto& p : points) { REQUIRE(solid -> Inside(p) == variants[0].second -> Inside(p)); }
+
+    BENCHMARK(label + " Inside, " + n_holes + " holes") {
+      unsigned inside = 0;
+      for (const auto& p : points) { inside += solid -> Inside(p) == kInside; }
+      return inside;
+    };
+
+    BENCHMARK(label + " DistanceToIn, " + n_holes + " holes") {
+      G4double total = 0;
+      for (const auto& p : points) { total += solid -> DistanceToIn(above(p), down); }
+      return total;
+    };
+  }
+}
@@ -0,0 +1,83 @@
+#include <n4-geometry-cache.hh>
+#include <n4-material.hh>
+#include <n4-shape.hh>
+#include <n4-boolean-shape.hh>
+
+#include <G4GeometryManager.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4SolidStore.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <filesystem>
+#include <string>
+
+// Startup cost of a geometry of n x n perforated tiles, either built by its
+// construct function (cold: no snapshot yet) or read from a GDML snapshot
+// written by an earlier run (warm).
+
+namespace {
+
+G4VPhysicalVolume* tiles(unsigned n) {
+  auto air   = n4::material("G4_AIR");
+  auto water = n4::material("G4_WATER");
+  auto pitch = 5*cm;
+  auto world = n4::box("world").cube(pitch * (n + 2)).place(air).now();
+  auto hole  = n4::tubs("hole").r(5*mm).z(3*cm);
+  for   (unsigned i=0; i<n; i++) {
+    for (unsigned j=0; j<n; j++) {
+      n4::box("tile").xy(4*cm).z(2*cm)
+        .subtract(hole).at_x(-1*cm)
+        .subtract(hole).at_x( 1*cm)
+        .name("tile-" + std::to_string(i) + "-" + std::to_string(j))
+        .place(water).in(world)
+        .at((i - n/2.) * pitch, (j - n/2.) * pitch, 0)
+        .now();
+    }
+  }
+  return world;
+}
+
+void forget_geometry() {
+  G4GeometryManager::GetInstance() -> OpenGeometry();
+  G4PhysicalVolumeStore::Clean();
+  G4LogicalVolumeStore ::Clean();
+  G4SolidStore         ::Clean();
+}
+
+} // namespace
+
+TEST_CASE("geometry cache cold vs warm startup", "[benchmark][geometry][cache]") {
+  auto n   = GENERATE(10u, 30u);
+  auto dir = (std::filesystem::temp_directory_path() / "n4-bench-geometry-cache").string();
+  auto key = "tiles " + std::to_string(n);
+  auto label = std::to_string(n * n) + " tiles";
+
+  BENCHMARK("construct, " + label) {
+    forget_geometry();
+    return tiles(n);
+  };
+
+  BENCHMARK("cold cache (construct and save), " + label) {
+    forget_geometry();
+    std::filesystem::remove_all(dir);
+    return n4::cached_geometry{dir, key, [n] { return tiles(n); }}.Construct();
+  };
+
+  forget_geometry();
+  n4::cached_geometry{dir, key, [n] { return tiles(n); }}.Construct();
+
+  BENCHMARK("warm cache (load), " + label) {
+    forget_geometry();
+    auto cached = n4::cached_geometry{dir, key, [n] { return tiles(n); }};
+    auto world  = cached.Construct();
+    REQUIRE(cached.loaded());
+    return world;
+  };
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,129 @@
+#include <n4-boolean-shape.hh>
+#include <n4-geometry-iterators.hh>
+#include <n4-inspect.hh>
+#include <n4-material.hh>
+#include <n4-place.hh>
+#include <n4-shape.hh>
+
+#include <G4Geantino.hh>
+#include <G4GeometryManager.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4SolidStore.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+// Cost of building geometry with n4::shape, n4::boolean_shape and n4::place,
+// and of inspecting it with the geometry iterators and find_* lookups.
+
+namespace {
+
+void forget_geometry() {
+  G4GeometryManager::GetInstance() -> OpenGeometry();
+  G4PhysicalVolumeStore::Clean();
+  G4LogicalVolumeStore ::Clean();
+  G4SolidStore         ::Clean();
+}
+
+// A world containing `n` rows of `n` boxes, each containing one tubs
+G4PVPlacement* grid(unsigned n) {
+  auto air   = n4::material("G4_AIR");
+  auto water = n4::material("G4_WATER");
+  auto pitch = 5*cm;
+  auto world = n4::box("world").cube(pitch * (n + 2)).place(air).now();
+  auto cell  = n4::box ("cell").cube(4*cm).volume(water);
+  auto rod   = n4::tubs("rod" ).r(1*cm).z(3*cm).volume(air);
+  n4::place(rod).in(cell).now();
+  for   (unsigned i=0; i<n; i++) {
+    for (unsigned j=0; j<n; j++) {
+      n4::place(cell).in(world)
+        .at((i - n/2.) * pitch, (j - n/2.) * pitch, 0)
+        .name("cell-" + std::to_string(i) + "-" + std::to_string(j))
+        .copy_no(i*n + j)
+        .now();
+    }
+  }
+  return world;
+}
+
+} // namespace
+
+TEST_CASE("geometry construction", "[benchmark][geometry][shape][place]") {
+  auto air = n4::material("G4_AIR");
+
+  BENCHMARK_ADVANCED("shape box solid")(Catch::Benchmark::Chronometer meter) {
+    forget_geometry();
+    meter.measure([] { return n4::box("box").xyz(1*m, 2*m, 3*m).solid(); });
+  };
+
+  BENCHMARK_ADVANCED("shape tubs volume")(Catch::Benchmark::Chronometer meter) {
+    forget_geometry();
+    meter.measure([air] { return n4::tubs("tubs").r_inner(1*cm).r(2*cm).z(1*m).phi_delta(90*deg).volume(air); });
+  };
+
+  BENCHMARK_ADVANCED("shape sphere volume")(Catch::Benchmark::Chronometer meter) {
+    forget_geometry();
+    meter.measure([air] { return n4::sphere("sphere").r_inner(1*cm).r(2*cm).theta_delta(45*deg).volume(air); });
+  };
+
+  BENCHMARK_ADVANCED("boolean subtract and add, 2 operations")(Catch::Benchmark::Chronometer meter) {
+    forget_geometry();
+    auto hole = n4::tubs("hole").r(1*cm).z(3*cm);
+    meter.measure([&hole] {
+      return n4::box("plate").cube(10*cm)
+        .subtract(hole).at_x(-2*cm)
+        .add     (n4::sphere("cap").r(1*cm)).at_z(5*cm)
+        .solid();
+    });
+  };
+
+  BENCHMARK_ADVANCED("place now, single")(Catch::Benchmark::Chronometer meter) {
+    forget_geometry();
+    auto world = n4::box("world").cube(1*m).volume(air);
+    auto box   = n4::box("box").cube(1*cm).volume(n4::material("G4_WATER"));
+    meter.measure([&] { return n4::place(box).in(world).at(1*cm, 2*cm, 3*cm).rot_z(30*deg).now(); });
+  };
+  forget_geometry();
+}
+
+TEST_CASE("geometry placement", "[benchmark][geometry][place]") {
+  auto n     = GENERATE(3u, 30u);
+  auto label = std::to_string(n * n) + " cells";
+
+  BENCHMARK("place grid, " + label) {
+    forget_geometry();
+    return grid(n);
+  };
+  forget_geometry();
+}
+
+TEST_CASE("geometry inspection", "[benchmark][geometry][iterator][find]") {
+  auto n     = GENERATE(3u, 30u);
+  auto label = std::to_string(n * n) + " cells";
+  forget_geometry();
+  auto world = grid(n);
+  auto last  = "cell-" + std::to_string(n-1) + "-" + std::to_string(n-1);
+
+  BENCHMARK("geometry_iterator traversal, " + label) {
+    size_t count = 0;
+    for ([[maybe_unused]] auto volume : world) { count++; }
+    return count;
+  };
+
+  BENCHMARK("find_physical, first of " + label) { return n4::find_physical("world", false); };
+  BENCHMARK("find_physical, last of "  + label) { return n4::find_physical(last   , false); };
+  BENCHMARK("find_logical, "           + label) { return n4::find_logical ("rod"  , false); };
+  BENCHMARK("find_solid, "             + label) { return n4::find_solid   ("rod"  , false); };
+  forget_geometry();
+}
+
+TEST_CASE("particle lookup", "[benchmark][find]") {
+  G4Geantino::Definition();
+  BENCHMARK("find_particle") { return n4::find_particle("geantino"); };
+}
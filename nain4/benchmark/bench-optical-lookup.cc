@@ -0,0 +1,150 @@
+#include <n4-constants.hh>
+#include <n4-main.hh>
+#include <n4-material.hh>
+#include <n4-sequences.hh>
+#include <n4-shape.hh>
+
+#include <FTFP_BERT.hh>
+#include <G4EmStandardPhysics_option4.hh>
+#include <G4Gamma.hh>
+#include <G4LogicalBorderSurface.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4OpticalPhysics.hh>
+#include <G4OpticalSurface.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+// Optical photon transport in the double-sipm CsI crystal wrapped in Teflon:
+// optical steps per second with the property vectors as given, which find
+// their bins by binary search, and after n4::fast_lookup. Most of these
+// spectra have only 2 nodes, which fast_lookup leaves alone: the gain grows
+// with the number of nodes in the tabulated spectra.
+
+namespace {
+
+size_t                     optical_steps      = 0;
+G4MaterialPropertiesTable* surface_properties = nullptr;
+
+G4MaterialPropertiesTable* csi_properties() {
+  // Same values as csi_with_properties in n4-examples/double-sipm
+  auto energies = n4::const_over(c4::hc/nm, {550, 360, 300, 260});
+  auto scint    = std::vector<G4double>    {0.0, 0.1, 1.0, 0.0};
+  return n4::material_properties()
+    .add("RINDEX"                    , energies, 1.79)
+    .add("SCINTILLATIONCOMPONENT1"   , energies, scint)
+    .add("SCINTILLATIONCOMPONENT2"   , energies, scint)
+    .add("ABSLENGTH"                 , energies, 5*m)
+    .add("SCINTILLATIONTIMECONSTANT1",            6*ns)
+    .add("SCINTILLATIONTIMECONSTANT2",           28*ns)
+    .add("SCINTILLATIONYIELD"        ,         3200/MeV)
+    .add("SCINTILLATIONYIELD1"       ,             0.57)
+    .add("SCINTILLATIONYIELD2"       ,             0.43)
+    .add("RESOLUTIONSCALE"           ,              1.0)
+    .done();
+}
+
+G4MaterialPropertiesTable* constant_rindex(G4double rindex) {
+  return n4::material_properties().add("RINDEX", {1*eV, 8.21*eV}, rindex).done();
+}
+
+void use_properties() {
+  n4::material("G4_CESIUM_IODIDE") -> SetMaterialPropertiesTable(csi_properties());
+  n4::material("G4_AIR"          ) -> SetMaterialPropertiesTable(constant_rindex(1   ));
+  n4::material("G4_TEFLON"       ) -> SetMaterialPropertiesTable(constant_rindex(1.35));
+  n4::run_manager::get().here_be_dragons() -> PhysicsHasBeenModified();
+}
+
+auto physics_list() {
+  auto physics =           new FTFP_BERT                  {0};
+  physics ->  ReplacePhysics(new G4EmStandardPhysics_option4{0});
+  physics -> RegisterPhysics(new G4OpticalPhysics           {0});
+  return physics;
+}
+
+auto geometry() {
+  auto scint_xy = 3*mm, scint_z = 20*mm, coating = 0.25*mm;
+  auto world   = n4::box("world").cube(10*cm).volume(n4::material("G4_AIR"));
+  auto teflon  = n4::box("coating").xy(scint_xy + 2*coating).z(scint_z + coating)
+    .place(n4::material("G4_TEFLON")).in(world).now();
+  auto crystal = n4::box("crystal").xy(scint_xy).z(scint_z)
+    .place(n4::material("G4_CESIUM_IODIDE")).in(teflon).at_z(coating/2).now();
+
+  auto surface = new G4OpticalSurface("csi-teflon");
+  surface -> SetType  (dielectric_dielectric);
+  surface -> SetModel (unified);
+  surface -> SetFinish(groundfrontpainted);
+  surface_properties = n4::material_properties()
+    .add("REFLECTIVITY", {2.038*eV, 4.144*eV}, 1.0)
+    .done();
+  surface -> SetMaterialPropertiesTable(surface_properties);
+  new G4LogicalBorderSurface("csi-teflon", crystal, teflon, surface);
+  return n4::place(world).now();
+}
+
+auto actions() {
+  auto gamma_into_crystal = [] (G4Event* event) {
+    auto vertex = new G4PrimaryVertex{{0, 0, -5*cm}, 0};
+    vertex -> SetPrimary(new G4PrimaryParticle{G4Gamma::Definition(), 0, 0, 511*keV});
+    event  -> AddPrimaryVertex(vertex);
+  };
+  auto count_optical = [] (G4Step const* step) {
+    if (step -> GetTrack() -> GetDefinition() == G4OpticalPhoton::Definition()) { optical_steps++; }
+  };
+  return (new n4::actions{gamma_into_crystal})
+    -> set(new n4::stepping_action{count_optical});
+}
+
+void ensure_run_manager() {
+  if (n4::run_manager::available()) { return; }
+  static char  name[] = "nain4-benchmark";
+  static char* argv[] = {name, nullptr};
+  n4::run_manager::create()
+    .ui("nain4-benchmark", 1, argv, false)
+    .physics (physics_list)
+    .geometry(geometry)
+    .actions (actions)
+    .run(0);
+}
+
+void report_optical_steps(char const* label, G4int events) {
+  G4Random::setTheSeed(12345);
+  optical_steps = 0;
+  auto start = std::chrono::steady_clock::now();
+  n4::run_manager::get_ui().beam_on(events);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "optical steps/s, " << label << ": " << optical_steps / elapsed.count()
+            << " (" << optical_steps << " steps)" << std::endl;
+}
+
+} // namespace
+
+TEST_CASE("optical property lookup", "[benchmark][optical]") {
+  ensure_run_manager();
+  auto events = 20;
+  auto& ui    = n4::run_manager::get_ui();
+
+  use_properties();
+  report_optical_steps("as given", events);
+  BENCHMARK("optical transport, as given") {
+    return ui.beam_on(events);
+  };
+
+  // In place: the optical processes keep using the same vectors
+  for (auto name : {"G4_CESIUM_IODIDE", "G4_AIR", "G4_TEFLON"}) {
+    n4::fast_lookup(n4::material(name) -> GetMaterialPropertiesTable());
+  }
+  n4::fast_lookup(surface_properties);
+  report_optical_steps("fast lookup", events);
+  BENCHMARK("optical transport, fast lookup") {
+    return ui.beam_on(events);
+  };
+}
@@ -0,0 +1,73 @@
+#include <n4-random.hh>
+#include <n4-sequences.hh>
+
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+// Cost of drawing one sample from each of the n4::random generators. Each
+// benchmark draws `n_samples` values, so divide the reported times by it.
+
+namespace {
+
+const size_t n_samples = 1000;
+
+template<class F> G4double draw(F sample) {
+  G4double total = 0;
+  for (size_t i=0; i<n_samples; i++) { total += sample(); }
+  return total;
+}
+
+} // namespace
+
+TEST_CASE("random scalars", "[benchmark][random]") {
+  G4Random::setTheSeed(1234);
+
+  BENCHMARK("uniform"      ) { return draw([] { return n4::random::uniform();                  }); };
+  BENCHMARK("uniform lo hi") { return draw([] { return n4::random::uniform(-2, 3);             }); };
+  BENCHMARK("biased_coin"  ) { return draw([] { return n4::random::biased_coin(0.3) ? 1.0 : 0; }); };
+  BENCHMARK("fair_die"     ) { return draw([] { return n4::random::fair_die(6);                }); };
+}
+
+TEST_CASE("random geometric", "[benchmark][random]") {
+  G4Random::setTheSeed(1234);
+  auto isotropic = n4::random::direction{};
+  auto cone      = n4::random::direction{}.max_theta(30*deg).rotate_y(90*deg);
+  auto excluded  = n4::random::direction{}.max_theta(30*deg).exclude();
+
+  BENCHMARK("direction, isotropic"    ) { return draw([&] { return isotropic.get().z(); }); };
+  BENCHMARK("direction, rotated cone" ) { return draw([&] { return      cone.get().z(); }); };
+  BENCHMARK("direction, excluded cone") { return draw([&] { return  excluded.get().z(); }); };
+  BENCHMARK("random_in_sphere"        ) { return draw([ ] { return n4::random::random_in_sphere(1*m).z(); }); };
+  BENCHMARK("random_on_disc"          ) { return draw([ ] { return std::get<0>(n4::random::random_on_disc(1*m)); }); };
+}
+
+TEST_CASE("random biased_choice", "[benchmark][random][biased_choice]") {
+  G4Random::setTheSeed(1234);
+  auto n_weights = GENERATE(2u, 10u, 1000u);
+  auto weights   = n4::vec_with_capacity<G4double>(n_weights);
+  for (unsigned i=0; i<n_weights; i++) { weights.push_back(1 + i % 7); }
+  auto label = std::to_string(n_weights) + " weights";
+
+  BENCHMARK("biased_choice construct, " + label) { return n4::random::biased_choice{weights}; };
+
+  auto choose = n4::random::biased_choice{weights};
+  BENCHMARK("biased_choice sample, "    + label) { return draw([&] { return choose(); }); };
+}
+
+TEST_CASE("random piecewise_linear_distribution", "[benchmark][random][piecewise_linear_distribution]") {
+  auto n_points = GENERATE(4u, 100u);
+  auto x        = n4::linspace(0, 10, n_points);
+  auto y        = n4::map<G4double>([] (auto x) { return 1 + x * (10 - x); }, x);
+  auto sampler  = n4::random::piecewise_linear_distribution{x, y};
+
+  BENCHMARK("piecewise_linear_distribution sample, " + std::to_string(n_points) + " points") {
+    return draw([&] { return sampler.sample(); });
+  };
+}
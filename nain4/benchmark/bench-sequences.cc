@@ -0,0 +1,65 @@
+#include <n4-random.hh>
+#include <n4-sequences.hh>
+#include <n4-stats.hh>
+
+#include <Randomize.hh>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <string>
+#include <vector>
+
+// n4::interpolator lookups and n4::stats reductions over sequences of
+// increasing length.
+
+namespace {
+
+// Fixed seed, so that every build sees the same data
+std::vector<G4double> sample_data(size_t n) {
+  G4Random::setTheSeed(1234);
+  auto data = n4::vec_with_capacity<G4double>(n);
+  for (size_t i=0; i<n; i++) { data.push_back(n4::random::uniform(-1, 1)); }
+  return data;
+}
+
+} // namespace
+
+TEST_CASE("sequences interpolator", "[benchmark][sequences][interpolator]") {
+  auto n_points = GENERATE(4u, 32u, 256u);
+  auto [x, y]   = n4::interpolate([] (auto x) { return x * x; }, n_points, 0, 1);
+  auto queries  = sample_data(1000);
+  for (auto& q : queries) { q = (q + 1) / 2; }
+  auto label = std::to_string(n_points) + " points, 1000 lookups";
+
+  BENCHMARK("interpolator construct, " + std::to_string(n_points) + " points") {
+    return n4::interpolator(x, y);
+  };
+
+  auto f = n4::interpolator(x, y);
+  BENCHMARK("interpolator lookup, " + label) {
+    G4double total = 0;
+    for (auto q : queries) { total += f(q).value_or(0); }
+    return total;
+  };
+}
+
+TEST_CASE("sequences linspace", "[benchmark][sequences]") {
+  auto n = GENERATE(10u, 10'000u);
+  BENCHMARK("linspace, " + std::to_string(n) + " entries") { return n4::linspace(0, 1, n); };
+}
+
+TEST_CASE("stats reductions", "[benchmark][stats]") {
+  auto n     = GENERATE(100u, 100'000u);
+  auto a     = sample_data(n);
+  auto b     = n4::map<G4double>([] (auto x) { return 2*x + 1; }, a);
+  auto label = std::to_string(n) + " values";
+
+  BENCHMARK("stats sum, "                 + label) { return n4::stats::sum                (a); };
+  BENCHMARK("stats mean, "                + label) { return n4::stats::mean               (a); };
+  BENCHMARK("stats variance_population, " + label) { return n4::stats::variance_population(a); };
+  BENCHMARK("stats std_dev_sample, "      + label) { return n4::stats::std_dev_sample     (a); };
+  BENCHMARK("stats min_max, "             + label) { return n4::stats::min_max            (a); };
+  BENCHMARK("stats correlation, "         + label) { return n4::stats::correlation     (a, b); };
+}
@@ -0,0 +1,12 @@
+#include <catch2/catch_session.hpp>
+
+int main(int argc, char** argv) {
+
+  // ----- Catch2 session --------------------------------------------------
+  // Benchmarks are ordinary Catch2 test cases containing BENCHMARK blocks.
+  // Use --benchmark-samples, --benchmark-no-analysis, etc. to tune them.
+  int result = Catch::Session().run(argc, argv);
+
+  // ----- Communicate benchmark result to OS ------------------------------
+  return result;
+}
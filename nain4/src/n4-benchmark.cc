@@ -0,0 +1,109 @@
+#include <n4-benchmark.hh>
+
+#include <G4RunManager.hh>
+#include <G4ios.hh>
+
+#include <iomanip>
+#include <map>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace benchmark {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+bool     enabled_ = false;
+unsigned warmup_  = 0;
+
+clock::time_point             created;
+std::map<std::string, double> phases;
+std::optional<summary>        last_;
+
+double seconds_since(clock::time_point start) {
+  return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+void switch_on (unsigned warmup_events) { enabled_ = true; warmup_ = warmup_events; }
+void switch_off()                       { enabled_ = false; }
+bool enabled   ()                       { return enabled_; }
+
+std::optional<summary> last() { return last_; }
+
+scope::scope(const char* phase) : phase{phase}, active{enabled_} {
+  if (active) { start = clock::now(); }
+}
+
+scope::~scope() {
+  if (active) { phases[phase] += seconds_since(start); }
+}
+
+void started() {
+  created = clock::now();
+  phases.clear();
+}
+
+void run(G4int events, std::function<void(G4int)> beam_on) {
+  // The first beamOn builds the physics tables, whatever the number of events
+  { scope timer{"physics tables"}; beam_on(0); }
+
+  summary s;
+  auto rm = G4RunManager::GetRunManager();
+  auto mt = rm -> GetRunManagerType() != G4RunManager::sequentialRM;
+  s.mode             = mt ? "multi-threaded" : "sequential";
+  s.threads          = mt ? rm -> GetNumberOfThreads() : 1;
+  s.startup_seconds  = seconds_since(created);
+  s.geometry_seconds = phases["geometry"];
+  s.physics_seconds  = phases["initialize"] - phases["geometry"] + phases["physics tables"];
+
+  if (warmup_) { beam_on(static_cast<G4int>(warmup_)); }
+
+  auto start = clock::now();
+  beam_on(events);
+  s.seconds         = seconds_since(start);
+  s.warmup_events   = warmup_;
+  s.events          = static_cast<size_t>(events);
+  if (s.seconds > 0) { s.events_per_second = s.events / s.seconds; }
+
+  last_ = s;
+  report    (G4cout, s);
+  write_json(G4cout, s);
+}
+
+void report(std::ostream& out, summary const& s) {
+  auto precision = out.precision();
+  out << "---- n4::benchmark: " << s.mode << ", " << s.threads << (s.threads == 1 ? " thread" : " threads") << " ----\n"
+      << std::fixed << std::setprecision(3)
+      << "startup  " << std::setw(10) << s.startup_seconds  << " s\n"
+      << "geometry " << std::setw(10) << s.geometry_seconds << " s\n"
+      << "physics  " << std::setw(10) << s.physics_seconds  << " s\n"
+      << "events   " << std::setw(10) << s.seconds          << " s for " << s.events
+      << " events, after " << s.warmup_events << " warm-up events\n"
+      << std::setprecision(1)
+      << "events/s " << std::setw(10) << s.events_per_second << '\n'
+      << std::defaultfloat << std::setprecision(precision) << std::flush;
+}
+
+void write_json(std::ostream& out, summary const& s) {
+  out << R"({"type":"benchmark","mode":")" << s.mode
+      << R"(","threads":)"                 << s.threads
+      << R"(,"warmup_events":)"            << s.warmup_events
+      << R"(,"events":)"                   << s.events
+      << R"(,"startup_seconds":)"          << s.startup_seconds
+      << R"(,"geometry_seconds":)"         << s.geometry_seconds
+      << R"(,"physics_seconds":)"          << s.physics_seconds
+      << R"(,"seconds":)"                  << s.seconds
+      << R"(,"events_per_second":)"        << s.events_per_second
+      << "}" << std::endl;
+}
+
+} // namespace benchmark
+} // namespace nain4
+
+#pragma GCC diagnostic pop
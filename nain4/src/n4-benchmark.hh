@@ -0,0 +1,73 @@
+#pragma once
+
+#include <G4Types.hh>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace benchmark {
+
+// ---- Startup and steady-state throughput of a whole application -------------------------------------
+// Off by default. Switch on (or pass --benchmark WARMUP on the CLI) to make
+// ui::run build the physics tables with an empty run, simulate WARMUP events
+// which are not measured, and then time the requested events. Combine with
+// --seed and --threads for reproducible numbers in sequential and
+// multi-threaded modes:
+//
+//   my-app --benchmark 100 -n 1000 --seed 1234 --threads 4
+//
+// The report is printed to G4cout, followed by the same numbers as a single
+// line of JSON starting with {"type":"benchmark", for collection by scripts.
+// In multi-threaded mode the workers are initialized during the warm-up run,
+// so WARMUP should be at least the number of threads. Cannot be combined with
+// --checkpoint or --processes.
+void switch_on (unsigned warmup_events);
+void switch_off();
+bool enabled   ();
+
+struct summary {
+  std::string mode;                  // "sequential" or "multi-threaded"
+  int         threads           = 1;
+  size_t      warmup_events     = 0;
+  size_t      events            = 0;
+  double      startup_seconds   = 0; // from run_manager::create until ready for the first event
+  double      geometry_seconds  = 0; // construction of the geometry
+  double      physics_seconds   = 0; // rest of the initialization, and building the physics tables
+  double      seconds           = 0; // of the measured events
+  double      events_per_second = 0;
+};
+
+// The last benchmark run
+std::optional<summary> last();
+void report    (std::ostream&, summary const&);
+void write_json(std::ostream&, summary const&);
+
+// Charges its own lifetime to `phase`, if benchmarking is on
+struct scope {
+  scope(const char* phase);
+  ~scope();
+  scope(const scope&) = delete;
+private:
+  const char*                           phase;
+  bool                                  active;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Hooks called by run_manager::create and ui::run
+void started();
+void run(G4int events, std::function<void(G4int)> beam_on);
+
+} // namespace benchmark
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -1,8 +1,15 @@
 #include <n4-boolean-shape.hh>
+#include <n4-cached-extent.hh>
+#include <n4-profile.hh>
 
-#include <G4UnionSolid.hh>
-#include <G4SubtractionSolid.hh>
+#include <G4DisplacedSolid.hh>
 #include <G4IntersectionSolid.hh>
+#include <G4MultiUnion.hh>
+#include <G4SubtractionSolid.hh>
+#include <G4UnionSolid.hh>
+
+#include <cstdlib>
+#include <iostream>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
@@ -10,11 +17,73 @@
 namespace nain4 {
 
 G4VSolid* boolean_shape::solid() const {
-  if (op == BOOL_OP::ADD) { return new G4UnionSolid       {name_, a, b, transformation}; }
-  if (op == BOOL_OP::SUB) { return new G4SubtractionSolid {name_, a, b, transformation}; }
-  if (op == BOOL_OP::INT) { return new G4IntersectionSolid{name_, a, b, transformation}; }
-  // Unreachable
-  return nullptr;
+  profile::scope timer{"boolean_shape::solid", name_};
+  auto name = cache_extent_ ? name_ + "-inner" : name_;
+  G4VSolid* solid = nullptr;
+  if (op == BOOL_OP::ADD) { solid = new G4UnionSolid       {name, a, b, transformation}; }
+  if (op == BOOL_OP::SUB) { solid = new G4SubtractionSolid {name, a, b, transformation}; }
+  if (op == BOOL_OP::INT) { solid = new G4IntersectionSolid{name, a, b, transformation}; }
+  if (cache_extent_) { return new cached_extent_solid{name_, solid}; }
+  return solid;
+}
+
+void multi_union::exit_if_empty(const char* method) const {
+  if (components.empty()) {
+    std::cerr << "Called `n4::multi_union::" << method << "` on "
+              << name_ << " before adding any component with `add`. Aborting."
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+multi_union& multi_union::apply(const char* method, const G4Transform3D& t) {
+  exit_if_empty(method);
+  auto& current = components.back().transformation;
+  current = t * current;
+  return *this;
+}
+
+G4VSolid* multi_union::solid() const {
+  exit_if_empty("solid");
+  profile::scope timer{"multi_union::solid", name_};
+  if (balanced_) { return balanced_tree(); }
+
+  auto the_union = new G4MultiUnion{name_};
+  for (auto& [solid, transformation] : components) {
+    the_union -> AddNode(*solid, transformation);
+  }
+  the_union -> Voxelize();
+  return the_union;
+}
+
+// Pair up neighbouring components level by level, so that the depth of the
+// resulting tree is log2(N) rather than N. Each node is expressed in the frame
+// of its left child, and carries the left child's transformation upwards.
+G4VSolid* multi_union::balanced_tree() const {
+  auto level = components;
+  if (level.size() == 1) {
+    auto [solid, transformation] = level.front();
+    return new G4DisplacedSolid{name_, solid, transformation};
+  }
+
+  while (level.size() > 1) {
+    std::vector<component> next;
+    next.reserve((level.size() + 1) / 2);
+    for (size_t i=0; i+1<level.size(); i+=2) {
+      auto& [a, ta] = level[i];
+      auto& [b, tb] = level[i+1];
+      next.push_back({new G4UnionSolid{name_ + "-node", a, b, ta.inverse() * tb}, ta});
+    }
+    if (level.size() % 2) { next.push_back(level.back()); }
+    level = std::move(next);
+  }
+
+  auto [root, transformation] = level.front();
+  if (transformation != HepGeom::Transform3D::Identity) {
+    return new G4DisplacedSolid{name_, root, transformation};
+  }
+  root -> SetName(name_);
+  return root;
 }
 
 } // namespace nain4
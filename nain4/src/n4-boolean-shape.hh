@@ -4,6 +4,7 @@
 #include <n4-shape.hh>
 
 #include <type_traits>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
@@ -35,14 +36,78 @@ struct boolean_shape : shape {
   boolean_shape& at_z(                    double z) { return at(0, 0, z); }
   boolean_shape& at(G4ThreeVector    p)           { return at(p.x(), p.y(), p.z()); }
   boolean_shape& name(G4String name)              { name_ = name; return *this; }
+  // Wrap the result in a cached_extent_solid (see n4-cached-extent.hh)
+  boolean_shape& cache_extent()                   { cache_extent_ = true; return *this; }
 private:
   boolean_shape(G4VSolid* a, G4VSolid* b, BOOL_OP op) : shape{a -> GetName()}, a{a}, b{b}, op{op}  {}
   G4VSolid* a;
   G4VSolid* b;
   BOOL_OP   op;
+  bool      cache_extent_ = false;
   G4Transform3D transformation = HepGeom::Transform3D::Identity;
 };
 
+// ---- Interface for constructing n-ary unions ------------------------------------------------------
+// Combines any number of solids into a single G4MultiUnion, whose internal
+// voxelization keeps the cost of Inside/DistanceToIn roughly independent of
+// the number of components, unlike chains of binary boolean solids whose cost
+// grows linearly with their depth. Transformations apply to the most recently
+// added component, just as they apply to the second operand of boolean_shape.
+//
+//   auto holes = n4::multi_union("holes");
+//   for (auto [x, y] : hole_positions) { holes.add(hole).at(x, y, 0); }
+//   auto plate = n4::box("plate").xy(1*m).z(1*cm).subtract_all(holes);
+//
+// .balanced() builds a balanced tree of G4UnionSolids instead of a G4MultiUnion.
+struct multi_union : shape {
+  multi_union(G4String name) : shape{name} {}
+  G4VSolid* solid() const override;
+
+  template<class SUBTYPE> multi_union& add (SUBTYPE x);
+  template<class SUBTYPE> multi_union& join(SUBTYPE x) { return add(x); }
+
+  multi_union& balanced()                         { balanced_ = true; return *this; }
+
+  multi_union& trans    (G4Transform3D&    t )    { return transform(t); }
+  multi_union& transform(G4Transform3D&    t )    { return apply("transform", t                         ); }
+  multi_union& rotate   (G4RotationMatrix& r )    { return apply("rotate"   , HepGeom::Rotate3D{r}      ); }
+  multi_union& rotate_x(double delta         )    { auto rot = G4RotationMatrix{}; rot.rotateX(delta); return rotate(rot);}
+  multi_union& rotate_y(double delta         )    { auto rot = G4RotationMatrix{}; rot.rotateY(delta); return rotate(rot);}
+  multi_union& rotate_z(double delta         )    { auto rot = G4RotationMatrix{}; rot.rotateZ(delta); return rotate(rot);}
+
+  multi_union& rot     (G4RotationMatrix& r  )    { return rotate(r); }
+  multi_union& rot_x   (double delta         )    { return rotate_x(delta); }
+  multi_union& rot_y   (double delta         )    { return rotate_y(delta); }
+  multi_union& rot_z   (double delta         )    { return rotate_z(delta); }
+  multi_union& at  (double x, double y, double z) { return apply("at", HepGeom::Translate3D{x,y,z}); }
+  multi_union& at_x(double x                    ) { return at(x, 0, 0); }
+  multi_union& at_y(          double y          ) { return at(0, y, 0); }
+  multi_union& at_z(                    double z) { return at(0, 0, z); }
+  multi_union& at(G4ThreeVector    p)             { return at(p.x(), p.y(), p.z()); }
+  multi_union& name(G4String name)                { name_ = name; return *this; }
+
+  size_t size() const { return components.size(); }
+
+private:
+  struct component { G4VSolid* solid; G4Transform3D transformation; };
+  multi_union& add_(G4VSolid* solid) { components.push_back({solid, HepGeom::Transform3D::Identity}); return *this; }
+  multi_union& apply(const char* method, const G4Transform3D& t);
+  void exit_if_empty(const char* method) const;
+  G4VSolid* balanced_tree() const;
+
+  std::vector<component> components;
+  bool                   balanced_ = false;
+};
+
+template<class SUBTYPE> multi_union& multi_union::add(SUBTYPE x) {
+  /**/ if constexpr (std::is_base_of_v<n4::shape, std::remove_pointer_t<SUBTYPE>>) { return add_(x.solid()); }
+  else if constexpr (std::is_base_of_v<G4VSolid , std::remove_pointer_t<SUBTYPE>>) { return add_(x        ); }
+  else {
+    static_assert( std::is_base_of_v<n4::shape, std::remove_pointer_t<SUBTYPE>>
+                , "n4::multi_union::add only accepts n4::shape and G4VSolid*");
+  }
+}
+
 // Clear and prominent error message
 #define CLEAR_ERROR_MSG(METHOD, TYPE_DESCRIPTION)                       \
 "\n\n\n\n"                                                              \
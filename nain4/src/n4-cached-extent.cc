@@ -0,0 +1,139 @@
+#include <n4-cached-extent.hh>
+
+#include <G4AffineTransform.hh>
+#include <G4BoundingEnvelope.hh>
+#include <G4VGraphicsScene.hh>
+#include <G4VisExtent.hh>
+#include <G4VoxelLimits.hh>
+
+#include <algorithm>
+#include <limits>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// The bounding box reported by a boolean solid is that of its operands, which
+// can be much larger than the solid itself (intersections, for example). The
+// extent along each axis, calculated without voxel limits, is usually tighter:
+// keep the intersection of both.
+cached_extent_solid::cached_extent_solid(const G4String& name, G4VSolid* solid)
+  : G4VSolid{name}
+  , solid{solid}
+{
+  solid -> BoundingLimits(min, max);
+
+  auto unlimited = G4VoxelLimits{};
+  auto identity  = G4AffineTransform{};
+  for (auto axis : {kXAxis, kYAxis, kZAxis}) {
+    G4double lo, hi;
+    if (solid -> CalculateExtent(axis, unlimited, identity, lo, hi)) {
+      min[axis] = std::max(min[axis], lo);
+      max[axis] = std::min(max[axis], hi);
+    }
+  }
+}
+
+bool cached_extent_solid::outside_box(const G4ThreeVector& p) const {
+  auto tol = kCarTolerance;
+  return p.x() < min.x() - tol || p.x() > max.x() + tol ||
+         p.y() < min.y() - tol || p.y() > max.y() + tol ||
+         p.z() < min.z() - tol || p.z() > max.z() + tol ;
+}
+
+// Slab test against the box, inflated by the surface tolerance
+bool cached_extent_solid::misses_box(const G4ThreeVector& p, const G4ThreeVector& v) const {
+  auto tol   = kCarTolerance;
+  auto enter = 0.;
+  auto leave = std::numeric_limits<G4double>::infinity();
+  for (auto axis : {0, 1, 2}) {
+    auto lo = min[axis] - tol;
+    auto hi = max[axis] + tol;
+    if (v[axis] == 0) {
+      if (p[axis] < lo || p[axis] > hi) { return true; }
+      continue;
+    }
+    auto t1 = (lo - p[axis]) / v[axis];
+    auto t2 = (hi - p[axis]) / v[axis];
+    if (t1 > t2) { std::swap(t1, t2); }
+    enter = std::max(enter, t1);
+    leave = std::min(leave, t2);
+    if (enter > leave) { return true; }
+  }
+  return false;
+}
+
+EInside cached_extent_solid::Inside(const G4ThreeVector& p) const {
+  if (outside_box(p)) { return kOutside; }
+  return solid -> Inside(p);
+}
+
+G4ThreeVector cached_extent_solid::SurfaceNormal(const G4ThreeVector& p) const {
+  return solid -> SurfaceNormal(p);
+}
+
+G4double cached_extent_solid::DistanceToIn(const G4ThreeVector& p, const G4ThreeVector& v) const {
+  if (misses_box(p, v)) { return kInfinity; }
+  return solid -> DistanceToIn(p, v);
+}
+
+// The distance to the box never exceeds the distance to the solid, so it is a
+// valid (if less tight) isotropic safety.
+G4double cached_extent_solid::DistanceToIn(const G4ThreeVector& p) const {
+  if (outside_box(p)) {
+    auto dx = std::max({min.x() - p.x(), p.x() - max.x(), 0.});
+    auto dy = std::max({min.y() - p.y(), p.y() - max.y(), 0.});
+    auto dz = std::max({min.z() - p.z(), p.z() - max.z(), 0.});
+    return std::max({dx, dy, dz});
+  }
+  return solid -> DistanceToIn(p);
+}
+
+G4double cached_extent_solid::DistanceToOut(const G4ThreeVector& p, const G4ThreeVector& v,
+                                            const G4bool calcNorm,
+                                            G4bool* validNorm, G4ThreeVector* n) const {
+  return solid -> DistanceToOut(p, v, calcNorm, validNorm, n);
+}
+
+G4double cached_extent_solid::DistanceToOut(const G4ThreeVector& p) const {
+  return solid -> DistanceToOut(p);
+}
+
+void cached_extent_solid::BoundingLimits(G4ThreeVector& pMin, G4ThreeVector& pMax) const {
+  pMin = min;
+  pMax = max;
+}
+
+G4bool cached_extent_solid::CalculateExtent(const EAxis pAxis, const G4VoxelLimits& pVoxelLimit,
+                                            const G4AffineTransform& pTransform,
+                                            G4double& pMin, G4double& pMax) const {
+  G4BoundingEnvelope bbox{min, max};
+  return bbox.CalculateExtent(pAxis, pVoxelLimit, pTransform, pMin, pMax);
+}
+
+G4VSolid* cached_extent_solid::Clone() const {
+  return new cached_extent_solid{GetName(), solid -> Clone()};
+}
+
+std::ostream& cached_extent_solid::StreamInfo(std::ostream& os) const {
+  os << "-----------------------------------------------------------\n"
+     << "    *** Dump for solid - " << GetName() << " ***\n"
+     << "    ===================================================\n"
+     << " Solid type: " << GetEntityType() << "\n"
+     << " Cached bounding box: " << min << " -> " << max << "\n"
+     << " Wrapping:\n";
+  return solid -> StreamInfo(os);
+}
+
+void cached_extent_solid::DescribeYourselfTo(G4VGraphicsScene& scene) const {
+  scene.AddSolid(*this);
+}
+
+G4VisExtent cached_extent_solid::GetExtent() const {
+  return G4VisExtent{min.x(), max.x(), min.y(), max.y(), min.z(), max.z()};
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+#include <G4VSolid.hh>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- Wrapper caching the extent of an expensive solid ----------------------------------------------
+// Deep boolean trees recompute BoundingLimits/CalculateExtent recursively every
+// time Geant4 asks for them (e.g. repeatedly during voxelisation), and every
+// navigation query descends the whole tree, even for points far from the solid.
+// cached_extent_solid computes the tightest available bounding box once, at
+// construction, uses it to answer all extent queries, and short-circuits
+// Inside/DistanceToIn for points or rays that miss the box. Everything else is
+// delegated to the wrapped solid.
+class cached_extent_solid : public G4VSolid {
+public:
+  cached_extent_solid(const G4String& name, G4VSolid* solid);
+
+  EInside       Inside       (const G4ThreeVector& p) const override;
+  G4ThreeVector SurfaceNormal(const G4ThreeVector& p) const override;
+
+  G4double DistanceToIn (const G4ThreeVector& p, const G4ThreeVector& v) const override;
+  G4double DistanceToIn (const G4ThreeVector& p                        ) const override;
+  G4double DistanceToOut(const G4ThreeVector& p, const G4ThreeVector& v,
+                         const G4bool calcNorm = false,
+                         G4bool* validNorm = nullptr, G4ThreeVector* n = nullptr) const override;
+  G4double DistanceToOut(const G4ThreeVector& p                        ) const override;
+
+  void   BoundingLimits (G4ThreeVector& pMin, G4ThreeVector& pMax) const override;
+  G4bool CalculateExtent(const EAxis pAxis, const G4VoxelLimits& pVoxelLimit,
+                         const G4AffineTransform& pTransform,
+                         G4double& pMin, G4double& pMax) const override;
+
+  G4double       GetCubicVolume   ()       override { return solid -> GetCubicVolume   (); }
+  G4double       GetSurfaceArea   ()       override { return solid -> GetSurfaceArea   (); }
+  G4ThreeVector  GetPointOnSurface() const override { return solid -> GetPointOnSurface(); }
+  G4GeometryType GetEntityType    () const override { return "N4CachedExtentSolid"; }
+  G4VSolid*      Clone            () const override;
+  std::ostream&  StreamInfo(std::ostream& os) const override;
+
+  void          DescribeYourselfTo(G4VGraphicsScene& scene) const override;
+  G4VisExtent   GetExtent         () const override;
+  G4Polyhedron* CreatePolyhedron  () const override { return solid -> CreatePolyhedron(); }
+  G4Polyhedron* GetPolyhedron     () const override { return solid -> GetPolyhedron   (); }
+
+  G4VSolid* constituent() const { return solid; }
+
+private:
+  bool outside_box(const G4ThreeVector& p                        ) const;
+  bool misses_box (const G4ThreeVector& p, const G4ThreeVector& v) const;
+
+  G4VSolid*     solid;
+  G4ThreeVector min;
+  G4ThreeVector max;
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,203 @@
+#include <n4-checkpoint.hh>
+#include <n4-convergence.hh>
+#include <n4-sub-events.hh>
+
+#include <G4Run.hh>
+#include <G4RunManager.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace fs = std::filesystem;
+
+namespace nain4 {
+namespace checkpoint {
+
+namespace {
+
+struct named_accumulator {
+  std::string name;
+  save_fn     save;
+  load_fn     load;
+};
+
+bool     enabled_    = false;
+fs::path dir_;
+size_t   chunk_size_ = default_chunk_size;
+bool     resume_     = false;
+size_t   done_       = 0;
+
+std::vector<named_accumulator> accumulators_;
+std::vector<std::string>       output_files_;
+
+// The `state` file names the last complete checkpoint. The other files of a
+// checkpoint carry its number, so a checkpoint interrupted while being
+// written never replaces the previous one.
+struct state {
+  size_t chunk            = 0;
+  size_t events_done      = 0;
+  size_t events_requested = 0;
+  std::vector<std::pair<uintmax_t, std::string>> files; // size, path
+};
+
+[[noreturn]] void fail(std::string const& message) {
+  std::cerr << "n4::checkpoint: " << message << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+// Fewer than `requested` if the run was aborted
+size_t events_in_last_run(size_t requested) {
+  auto manager = G4RunManager::GetRunManager();
+  auto run     = manager ? manager -> GetCurrentRun() : nullptr;
+  if (! run) { return requested; }
+  auto events = static_cast<size_t>(run -> GetNumberOfEvent());
+  if (sub_events::enabled()) { events /= sub_events::parts(); }
+  return std::min(events, requested);
+}
+
+fs::path file_of(std::string const& what, size_t chunk) { return dir_ / (what + "-" + std::to_string(chunk)); }
+
+std::optional<state> read_state() {
+  std::ifstream in{dir_ / "state"};
+  if (! in) { return {}; }
+
+  state s;
+  std::string key;
+  while (in >> key) {
+    if      (key == "chunk"           ) { in >> s.chunk; }
+    else if (key == "events_done"     ) { in >> s.events_done; }
+    else if (key == "events_requested") { in >> s.events_requested; }
+    else if (key == "file"            ) {
+      uintmax_t size; std::string path;
+      in >> size >> std::ws;
+      std::getline(in, path);
+      s.files.emplace_back(size, path);
+    }
+    else { fail("unexpected '" + key + "' in " + (dir_ / "state").string()); }
+  }
+  return s;
+}
+
+void write(state const& s) {
+  G4Random::saveEngineStatus(file_of("rng", s.chunk).c_str());
+  for (auto& a : accumulators_) {
+    std::ofstream out{file_of("accumulator-" + a.name, s.chunk), std::ios::binary};
+    a.save(out);
+    if (! out) { fail("cannot save accumulator '" + a.name + "' in " + dir_.string()); }
+  }
+
+  auto tmp = dir_ / "state.tmp";
+  {
+    std::ofstream out{tmp};
+    out << "chunk "            << s.chunk            << '\n'
+        << "events_done "      << s.events_done      << '\n'
+        << "events_requested " << s.events_requested << '\n';
+    for (auto& [size, path] : s.files) { out << "file " << size << ' ' << path << '\n'; }
+    if (! out) { fail("cannot write " + tmp.string()); }
+  }
+  fs::rename(tmp, dir_ / "state");
+
+  // The previous checkpoint is no longer needed
+  fs::remove(file_of("rng", s.chunk - 1));
+  for (auto& a : accumulators_) { fs::remove(file_of("accumulator-" + a.name, s.chunk - 1)); }
+}
+
+void restore(state const& s) {
+  G4Random::restoreEngineStatus(file_of("rng", s.chunk).c_str());
+  for (auto& a : accumulators_) {
+    std::ifstream in{file_of("accumulator-" + a.name, s.chunk), std::ios::binary};
+    if (! in) { fail("no accumulator '" + a.name + "' in checkpoint " + std::to_string(s.chunk)); }
+    a.load(in);
+  }
+  for (auto& [size, path] : s.files) {
+    if (fs::exists(path) && fs::file_size(path) > size) { fs::resize_file(path, size); }
+  }
+}
+
+} // anonymous namespace
+
+void switch_on(std::string const& dir, size_t chunk_size, bool resume) {
+  if (chunk_size == 0) { fail("the chunk size must be positive"); }
+  enabled_    = true;
+  dir_        = dir;
+  chunk_size_ = chunk_size;
+  resume_     = resume;
+}
+
+void switch_off() {
+  enabled_ = false;
+  accumulators_.clear();
+  output_files_.clear();
+}
+
+bool enabled() { return enabled_; }
+
+void accumulator(std::string const& name, save_fn save, load_fn load) {
+  auto same_name = [&name] (auto const& a) { return a.name == name; };
+  accumulators_.erase(std::remove_if(begin(accumulators_), end(accumulators_), same_name), end(accumulators_));
+  accumulators_.push_back({name, save, load});
+}
+
+void output_file(std::string const& path) {
+  if (std::find(cbegin(output_files_), cend(output_files_), path) == cend(output_files_)) {
+    output_files_.push_back(path);
+  }
+}
+
+size_t events_done() { return done_; }
+
+void run(G4int events, std::function<void(G4int)> beam_on) {
+  // Convergence would restart its estimate in every chunk, and end the job
+  // by aborting one of them
+  if (convergence::enabled()) { fail("cannot be combined with n4::convergence"); }
+  fs::create_directories(dir_);
+
+  state s;
+  if (! resume_) { fs::remove(dir_ / "state"); }
+  if (resume_) {
+    if (auto last = read_state()) {
+      s = last.value();
+      restore(s);
+      G4cout << "n4::checkpoint: resuming from " << dir_.string()
+             << " after " << s.events_done << " events" << G4endl;
+    }
+  }
+
+  auto requested     = static_cast<size_t>(std::max(events, 0));
+  s.events_requested = requested;
+  done_              = s.events_done;
+  while (done_ < requested) {
+    auto n = std::min(chunk_size_, requested - done_);
+    beam_on(static_cast<G4int>(n));
+    auto ran      = events_in_last_run(n);
+    done_        += ran;
+    s.events_done = done_;
+    s.chunk++;
+    s.files.clear();
+    for (auto& path : output_files_) {
+      s.files.emplace_back(fs::exists(path) ? fs::file_size(path) : 0, path);
+    }
+    write(s);
+    if (ran < n) {
+      G4cout << "n4::checkpoint: run aborted after " << done_ << " events" << G4endl;
+      break;
+    }
+  }
+}
+
+} // namespace checkpoint
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace checkpoint {
+
+// ---- Long runs in chunks, with checkpoints to resume from --------------------------------------------
+// Off by default. Switch on (or pass --checkpoint DIR on the CLI, with
+// --chunk-size N and --resume) to make ui::run simulate the requested events
+// in chunks of `chunk_size`, one beamOn each, saving after every chunk in `dir`
+//  - the state of the random engine,
+//  - the number of events done,
+//  - the user accumulators registered with `accumulator`,
+//  - the sizes of the output files registered with `output_file`.
+// With `resume` the run continues from the last checkpoint found in `dir`, if
+// there is one: accumulators are restored and output files are truncated to
+// their checkpointed sizes, discarding whatever the interrupted chunk wrote.
+// Each chunk is a Geant4 run, so flush output at the end of each run. A chunk
+// whose run is aborted counts the events it simulated, and is the last one.
+// Cannot be combined with --benchmark, --processes or n4::convergence.
+constexpr size_t default_chunk_size = 10'000;
+
+void switch_on (std::string const& dir, size_t chunk_size = default_chunk_size, bool resume = false);
+void switch_off(); // also forgets the accumulators and output files
+bool enabled   ();
+
+// State to be saved at each checkpoint and restored when resuming
+using save_fn = std::function<void (std::ostream&)>;
+using load_fn = std::function<void (std::istream&)>;
+void accumulator(std::string const& name, save_fn save, load_fn load);
+
+template<class T>
+void accumulator(std::string const& name, T& value) {
+  static_assert(std::is_trivially_copyable_v<T>, "n4::checkpoint::accumulator needs save and load functions for this type");
+  accumulator(name,
+              [&value] (std::ostream& out) { out.write(reinterpret_cast<char const*>(&value), sizeof(T)); },
+              [&value] (std::istream& in ) { in .read (reinterpret_cast<char      *>(&value), sizeof(T)); });
+}
+
+void output_file(std::string const& path);
+
+// Events done in earlier chunks of the current run. Event IDs start from 0
+// in every chunk: add this to get IDs which are unique across the whole run.
+// With n4::sub_events, add it to sub_events::event_of instead.
+size_t events_done();
+
+// Hook called by ui::run
+void run(G4int events, std::function<void(G4int)> beam_on);
+
+} // namespace checkpoint
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,77 @@
+#include <n4-convergence.hh>
+
+#include <G4RunManager.hh>
+#include <G4ios.hh>
+
+#include <atomic>
+#include <mutex>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace convergence {
+
+namespace {
+
+bool         enabled_    = false;
+G4double     precision_  = 0;
+size_t       min_events_ = 0;
+estimator_fn estimator_;
+
+std::mutex             mutex;
+stats::running         estimate;
+std::atomic<size_t>    events    = 0;
+std::atomic<bool>      converged = false;
+std::optional<summary> last_;
+
+} // anonymous namespace
+
+void stop_at(G4double relative_precision, estimator_fn estimator, size_t min_events) {
+  enabled_    = true;
+  precision_  = relative_precision;
+  min_events_ = min_events;
+  estimator_  = estimator;
+}
+
+void switch_off() { enabled_ = false; estimator_ = {}; }
+bool enabled   () { return enabled_; }
+
+std::optional<summary> last_run() { return last_; }
+
+void run_started() {
+  std::lock_guard<std::mutex> lock{mutex};
+  estimate  = {};
+  events    = 0;
+  converged = false;
+}
+
+void event_finished(G4Event const* event) {
+  events++;
+  if (! converged) {
+    if (auto value = estimator_(event)) {
+      std::lock_guard<std::mutex> lock{mutex};
+      estimate.add(value.value());
+      auto error = estimate.relative_error();
+      if (estimate.count() >= min_events_ && error.has_value() && error.value() <= precision_) {
+        converged = true;
+      }
+    }
+  }
+  // In multi-threaded mode this is the run manager of the worker thread
+  if (converged) { G4RunManager::GetRunManager() -> AbortRun(true); }
+}
+
+void run_finished() {
+  std::lock_guard<std::mutex> lock{mutex};
+  last_ = summary{estimate, events, converged};
+  G4cout << "n4::convergence: relative error ";
+  if (auto error = estimate.relative_error()) { G4cout << error.value(); } else { G4cout << "undefined"; }
+  G4cout << (converged ? " <= " : ", target ") << precision_
+         << ", after " << events << " events" << G4endl;
+}
+
+} // namespace convergence
+} // namespace nain4
+
+#pragma GCC diagnostic pop
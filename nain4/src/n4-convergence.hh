@@ -0,0 +1,56 @@
+#pragma once
+
+#include <n4-stats.hh>
+
+#include <G4Event.hh>
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace convergence {
+
+// ---- Stop runs as soon as an observable is known well enough -----------------------------------------
+// Off by default. `stop_at` switches it on: at the end of each event
+// `estimator` gives the value of the observable in that event (or nothing, to
+// leave the event out), and the run is aborted as soon as the standard error
+// of the mean, relative to the mean, is at most `relative_precision`, once
+// `min_events` values have been collected. The number of events requested
+// (run(n), --beam-on, /run/beamOn) becomes the maximum.
+//
+//   n4::convergence::stop_at(0.01, [&] (auto) { return energy_in_detector; });
+//   n4::run_manager::create() ... .run(1'000'000);
+//   auto energy = n4::convergence::last_run() -> estimate.mean();
+//
+// In multi-threaded mode `estimator` is called in the thread that simulated
+// the event, and the workers stop within an event of each other.
+using estimator_fn = std::function<std::optional<G4double> (G4Event const*)>;
+void stop_at(G4double relative_precision, estimator_fn estimator, size_t min_events = 100);
+void switch_off();
+bool enabled   ();
+
+struct summary {
+  stats::running estimate;
+  size_t         events    = 0;     // simulated, including those left out
+  bool           converged = false;
+};
+
+// The last run that finished with convergence switched on
+std::optional<summary> last_run();
+
+// Hooks called by n4::run_action and n4::event_action
+void run_started   ();
+void event_finished(G4Event const*);
+void run_finished  ();
+
+} // namespace convergence
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
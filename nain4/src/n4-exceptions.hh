@@ -31,6 +31,7 @@ struct NAME : exception {                                   \
 
 EXCEPTION(not_found)
 EXCEPTION(bad_cast)
+EXCEPTION(parse_error)
 
 #undef N4_EXCEPTION
 #undef WRAP
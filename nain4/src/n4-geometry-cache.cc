@@ -0,0 +1,118 @@
+#include <n4-geometry-cache.hh>
+#include <n4-hash.hh>
+#include <n4-profile.hh>
+
+#include <G4GDMLParser.hh>
+#include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4SDManager.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VSensitiveDetector.hh>
+#include <G4Version.hh>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace fs = std::filesystem;
+
+namespace nain4 {
+
+static const G4String sensitive_aux = "n4::SensitiveDetector";
+
+cached_geometry::cached_geometry(const std::string& dir, const std::string& key, geometry::construct_fn construct)
+  : G4VUserDetectorConstruction{}
+  , dir{dir}
+  , construct{construct}
+{
+  auto hash = fnv1a(key, fnv1a(G4Version));
+  stem = (fs::path{dir} / ("geometry-" + hex(hash))).string();
+}
+
+G4VPhysicalVolume* cached_geometry::Construct() {
+  if (valid()) {
+    profile::scope timer{"cached_geometry", "load"};
+    loaded_ = true;
+    return load();
+  }
+
+  loaded_ = false;
+  G4VPhysicalVolume* world;
+  {
+    profile::scope timer{"cached_geometry", "construct"};
+    world = construct();
+  }
+  profile::scope timer{"cached_geometry", "save"};
+  save(world);
+  return world;
+}
+
+// The hash is written after the GDML file is complete, so a snapshot is valid
+// only if both exist and agree.
+bool cached_geometry::valid() const {
+  std::ifstream sidecar{stem + ".fnv1a"};
+  std::string expected;
+  if (! (sidecar >> expected)) { return false; }
+  auto actual = fnv1a_file(stem + ".gdml");
+  return actual.has_value() && hex(actual.value()) == expected;
+}
+
+G4VPhysicalVolume* cached_geometry::load() {
+  make_detectors();
+
+  G4GDMLParser parser;
+  parser.Read(stem + ".gdml", false);
+
+  auto sd_manager = G4SDManager::GetSDMpointer();
+  for (auto& [volume, aux_list] : *parser.GetAuxMap()) {
+    for (auto& aux : aux_list) {
+      if (aux.type != sensitive_aux) { continue; }
+      auto detector = sd_manager -> FindSensitiveDetector(aux.value, false);
+      if (! detector) {
+        std::cerr << "n4::cached_geometry: logical volume " << volume -> GetName()
+                  << " needs sensitive detector '" << aux.value << "', which does not exist.\n"
+                  << "Create it in the function given to `cached_geometry::detectors`."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      volume -> SetSensitiveDetector(detector);
+    }
+  }
+  return parser.GetWorldVolume();
+}
+
+// Concurrent jobs may race to create the same snapshot: each writes to files
+// of its own and renames them into place, which is atomic.
+void cached_geometry::save(G4VPhysicalVolume* world) const {
+  fs::create_directories(dir);
+
+  G4GDMLParser parser;
+  for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    if (auto detector = volume -> GetSensitiveDetector()) {
+      parser.AddVolumeAuxiliary({sensitive_aux, detector -> GetFullPathName(), "", nullptr}, volume);
+    }
+  }
+
+  auto tmp = stem + ".tmp-" + std::to_string(getpid());
+  parser.Write(tmp + ".gdml", world, true);
+
+  auto hash = fnv1a_file(tmp + ".gdml");
+  if (! hash.has_value()) {
+    std::cerr << "n4::cached_geometry: could not write " << tmp << ".gdml; geometry not cached." << std::endl;
+    return;
+  }
+  std::ofstream{tmp + ".fnv1a"} << hex(hash.value()) << std::endl;
+
+  fs::rename(tmp + ".gdml" , stem + ".gdml" );
+  fs::rename(tmp + ".fnv1a", stem + ".fnv1a");
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <n4-mandatory.hh>
+
+#include <G4VUserDetectorConstruction.hh>
+
+#include <functional>
+#include <string>
+
+class G4VPhysicalVolume;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- Geometry that is built once and then loaded from a GDML snapshot ------------------------------
+// The first process to use a given `key` runs `construct` and writes the
+// resulting geometry to `dir` as GDML, along with the hash of its contents.
+// Later processes with the same `key` read the snapshot instead of calling
+// `construct`. `key` must describe everything the geometry depends on (e.g.
+// its parameters); the Geant4 version is added to it automatically. Snapshots
+// that are incomplete or whose contents do not match their hash are rebuilt.
+//
+//   n4::run_manager::create()
+//     ...
+//     .geometry(new n4::cached_geometry{"cache", "detector-v3 r=" + std::to_string(r), build})
+//
+// GDML does not store sensitive detectors: the name of the detector attached
+// to each logical volume is saved as auxiliary information and, on load, the
+// detector of that name is looked up in G4SDManager. Use `.detectors(fn)` to
+// create (and register) those detectors when the snapshot is loaded. Vis
+// attributes are not preserved, and only solids known to GDML can be saved.
+struct cached_geometry : public G4VUserDetectorConstruction {
+  using detectors_fn = std::function<void()>;
+
+  cached_geometry(const std::string& dir, const std::string& key, geometry::construct_fn construct);
+  G4VPhysicalVolume* Construct() override;
+
+  cached_geometry* detectors(detectors_fn f) { make_detectors = f; return this; }
+
+  // Path of the snapshot, without extension
+  const std::string& path()   const { return stem; }
+  // Whether the last Construct() loaded the snapshot rather than building it
+  bool               loaded() const { return loaded_; }
+
+private:
+  G4VPhysicalVolume* load ();
+  void               save (G4VPhysicalVolume* world) const;
+  bool               valid() const;
+
+  std::string            dir;
+  std::string            stem;
+  geometry::construct_fn construct;
+  detectors_fn           make_detectors = [] {};
+  bool                   loaded_ = false;
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -2,9 +2,13 @@
 
 #include <n4-material.hh>
 
+#include <n4-overlaps.hh>
 #include <n4-place.hh>
 #include <n4-shape.hh>
 #include <n4-boolean-shape.hh>
+#include <n4-cached-extent.hh>
 #include <n4-volume.hh>
+#include <n4-geometry-cache.hh>
 
+#include <n4-photodetector.hh>
 #include <n4-sensitive.hh>
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace nain4 {
+
+// ---- 64-bit FNV-1a: fast, non-cryptographic hashes for cache keys ----------------------------------
+// Chain calls to hash several pieces: fnv1a(b, fnv1a(a)).
+constexpr uint64_t fnv1a_basis = 0xcbf29ce484222325ull;
+
+constexpr uint64_t fnv1a(std::string_view data, uint64_t hash = fnv1a_basis) {
+  for (auto c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Hash of a whole file, or nothing if it cannot be read
+inline std::optional<uint64_t> fnv1a_file(const std::string& path) {
+  std::ifstream in{path, std::ios::binary};
+  if (! in) { return {}; }
+  auto hash = fnv1a_basis;
+  char buffer[1 << 16];
+  while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+    hash = fnv1a({buffer, static_cast<size_t>(in.gcount())}, hash);
+  }
+  return hash;
+}
+
+inline std::string hex(uint64_t hash) {
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+  return text;
+}
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
@@ -1,4 +1,7 @@
 #pragma once
 
 #include <n4-mandatory.hh>
+#include <n4-optical-stacking.hh>
 #include <n4-run-manager.hh>
+#include <n4-scan.hh>
+#include <n4-step-profiler.hh>
@@ -1,6 +1,16 @@
 #include <n4-mandatory.hh>
+#include <n4-benchmark.hh>
+#include <n4-profile.hh>
+#include <n4-sensitive.hh>
 
+#include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
 #include <G4Run.hh>
+#include <G4SDManager.hh>
+#include <G4VSensitiveDetector.hh>
+
+#include <cstdlib>
+#include <iostream>
 
 namespace nain4 {
 
@@ -9,13 +19,46 @@ namespace nain4 {
 
 // ----- actions --------------------------------------------------------------------
 void actions::Build() const {
+  // Sub-events are generated, offloaded and waited for by the n4 actions
+  if (sub_events::enabled()) {
+    auto require = [] (bool ok, char const* what) {
+      if (ok) { return; }
+      std::cerr << "n4::sub_events needs " << what << std::endl;
+      exit(EXIT_FAILURE);
+    };
+    require(            dynamic_cast<generator      *>(generator_), "the primaries to come from an n4::generator");
+    require(! event_ || dynamic_cast<event_action   *>(event_    ), "the event action, if any, to be an n4::event_action");
+    require(! stack_ || dynamic_cast<stacking_action*>(stack_    ), "the stacking action, if any, to be an n4::stacking_action");
+  }
   SetUserAction(generator_);
   if (  run_) { SetUserAction(  run_); }
   if (event_) { SetUserAction(event_); }
   if ( step_) { SetUserAction( step_); }
   if (track_) { SetUserAction(track_); }
   if (stack_) { SetUserAction(stack_); }
+  // The instrumentation lives in the n4 actions: make sure they are there
+  auto tracks = track_stats::enabled();
+  auto events =   telemetry::enabled() || convergence::enabled();
+  auto split  =  sub_events::enabled();
+  if ((tracks || events         ) && !   run_) { SetUserAction(new      run_action); }
+  if ((          events || split) && ! event_) { SetUserAction(new    event_action); }
+  if ( tracks                     && ! track_) { SetUserAction(new tracking_action); }
+  if ((tracks ||           split) && ! stack_) { SetUserAction(new stacking_action); }
+}
+
+void actions::BuildForMaster() const {
+  if (track_stats::enabled() || telemetry::enabled() || convergence::enabled()) { SetUserAction(new run_action); }
+}
+// ----- actions_per_thread ----------------------------------------------------------
+G4VUserActionInitialization* actions_per_thread::for_this_thread() const {
+  std::lock_guard<std::mutex> lock{mutex};
+  auto& actions = built[G4Threading::G4GetThreadId()];
+  if (! actions) { actions.reset(build()); }
+  return actions.get();
 }
+
+void actions_per_thread::BuildForMaster() const { for_this_thread() -> BuildForMaster(); }
+void actions_per_thread::Build         () const { for_this_thread() -> Build         (); }
 // ----- primary generator -----------------------------------------------------------
 void generator::geantino_along_x(G4Event* event) {
   // TODO this doesn't really belong in n4 itself
@@ -25,6 +68,33 @@ void generator::geantino_along_x(G4Event* event) {
   // vertex->SetPrimary(new G4PrimaryParticle(geantino, p, 0, 0));
   // event->AddPrimaryVertex(vertex);
 }
+// ----- geometry --------------------------------------------------------------------
+G4VPhysicalVolume* geometry::Construct() {
+  profile  ::scope timer{"geometry::Construct"};
+  benchmark::scope bench{"geometry"};
+  auto world = construct();
+  detectors.clear();
+  for (auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    if (auto detector = volume -> GetSensitiveDetector()) { detectors.emplace_back(volume, detector); }
+  }
+  return world;
+}
+
+void geometry::ConstructSDandField() {
+  if (! G4Threading::IsWorkerThread()) { return; }
+  auto sd_manager = G4SDManager::GetSDMpointer();
+  std::map<G4VSensitiveDetector*, G4VSensitiveDetector*> clones; // volumes may share a detector
+  for (auto [volume, detector] : detectors) {
+    auto& clone = clones[detector];
+    if (! clone) {
+      clone = detector -> Clone();
+      if (! sd_manager -> FindSensitiveDetector(clone -> GetFullPathName(), false)) {
+        fully_activate_sensitive_detector(clone);
+      }
+    }
+    volume -> SetSensitiveDetector(clone);
+  }
+}
 
 #pragma GCC diagnostic pop
 
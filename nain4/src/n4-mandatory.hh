@@ -1,5 +1,12 @@
 #pragma once
 
+#include <n4-convergence.hh>
+#include <n4-sub-events.hh>
+#include <n4-telemetry.hh>
+#include <n4-track-stats.hh>
+
+#include <G4Threading.hh>
+#include <G4ios.hh>
 #include <G4Track.hh>
 #include <G4UserEventAction.hh>
 #include <G4UserRunAction.hh>
@@ -11,6 +18,12 @@
 #include <G4VUserEventInformation.hh>
 #include <G4VUserPrimaryGeneratorAction.hh>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 
@@ -25,8 +38,22 @@ struct run_action : public G4UserRunAction {
     if (generate_) { return generate_(); }
     else { return G4UserRunAction::GenerateRun(); }
   }
-  void BeginOfRunAction(const G4Run* run) override { if (begin_) begin_(run); }
-  void   EndOfRunAction(const G4Run* run) override { if   (end_)   end_(run); }
+  void BeginOfRunAction(const G4Run* run) override {
+    if (G4Threading::IsMasterThread()) {
+      if (track_stats::enabled()) { track_stats::reset(); }
+      if (  telemetry::enabled()) {   telemetry::run_started(run -> GetNumberOfEventToBeProcessed()); }
+      if (convergence::enabled()) { convergence::run_started(); }
+    }
+    if (begin_) begin_(run);
+  }
+  void EndOfRunAction(const G4Run* run) override {
+    if (end_) end_(run);
+    if (G4Threading::IsMasterThread()) {
+      if (convergence::enabled()) { convergence::run_finished(); }
+      if (  telemetry::enabled()) {   telemetry::run_finished(); }
+      if (track_stats::enabled()) { track_stats::report(G4cout); }
+    }
+  }
 
   run_action* generate(generate_t action) { generate_ = action; return this; }
   run_action*    begin(action_t   action) {    begin_ = action; return this; }
@@ -41,8 +68,16 @@ private:
 struct event_action : public G4UserEventAction {
   using action_t = std::function<void (G4Event const*)>;
 
-  void BeginOfEventAction(G4Event const* event) override { if (begin_) begin_(event); }
-  void   EndOfEventAction(G4Event const* event) override { if   (end_)   end_(event); }
+  void BeginOfEventAction(G4Event const* event) override {
+    if (telemetry::enabled()) { telemetry::event_started(); }
+    if (begin_) begin_(event);
+  }
+  void EndOfEventAction(G4Event const* event) override {
+    if (end_) end_(event);
+    if (  telemetry::enabled()) {   telemetry::event_finished(); }
+    if (convergence::enabled()) { convergence::event_finished(event); }
+    if ( sub_events::enabled()) {  sub_events::event_finished(event); }
+  }
 
   event_action* begin(action_t action) { begin_ = action; return this; }
   event_action*   end(action_t action) {   end_ = action; return this; }
@@ -58,11 +93,16 @@ struct stacking_action : public G4UserStackingAction {
   using voidvoid_t = std::function<void              (                        )>;
 
   G4ClassificationOfNewTrack ClassifyNewTrack(G4Track const* track) override {
-    if (classify_) {return classify_(track); }
-    else { return G4UserStackingAction::ClassifyNewTrack(track); }
+    auto classification = classify_ ? classify_(track) : G4UserStackingAction::ClassifyNewTrack(track);
+    if (sub_events::enabled() && classification != fKill && sub_events::offload(track)) { classification = fKill; }
+    if (track_stats::enabled()) { track_stats::classified(track, classification, stackManager); }
+    return classification;
   }
   void NewStage       () override { if   (stage_)   stage_(stackManager); }
-  void PrepareNewEvent() override { if (prepare_) prepare_(); }
+  void PrepareNewEvent() override {
+    if (track_stats::enabled()) { track_stats::new_event(); }
+    if (prepare_) prepare_();
+  }
 
   stacking_action*   classify(classify_t a) { classify_ = a; return this; }
   stacking_action* next_stage(   stage_t a) {    stage_ = a; return this; }
@@ -76,8 +116,14 @@ private:
 // ----- tracking_action ------------------------------------------------------------
 struct tracking_action : public G4UserTrackingAction {
   using action_t = std::function<void (const G4Track*)>;
-  void  PreUserTrackingAction(const G4Track* track) override { if ( pre_)  pre_(track); }
-  void PostUserTrackingAction(const G4Track* track) override { if (post_) post_(track); }
+  void PreUserTrackingAction(const G4Track* track) override {
+    if (track_stats::enabled()) { track_stats::track_started(track); }
+    if (pre_) pre_(track);
+  }
+  void PostUserTrackingAction(const G4Track* track) override {
+    if (post_) post_(track);
+    if (track_stats::enabled()) { track_stats::track_finished(track); }
+  }
 
   tracking_action* pre (action_t a) { pre_  = a; return this; }
   tracking_action* post(action_t a) { post_ = a; return this; }
@@ -100,7 +146,10 @@ private:
 struct generator : public G4VUserPrimaryGeneratorAction {
   using function = std::function<void (G4Event*)>;
   generator(function fn = geantino_along_x) : doit{fn} {}
-  void GeneratePrimaries(G4Event* event) override { doit(event); };
+  void GeneratePrimaries(G4Event* event) override {
+    if (sub_events::enabled() && sub_events::generate(event)) { return; }
+    doit(event);
+  };
 private:
   function const doit;
   static void geantino_along_x(G4Event*);
@@ -111,8 +160,8 @@ struct actions : public G4VUserActionInitialization {
   actions(G4VUserPrimaryGeneratorAction* generator) : generator_{generator} {}
   actions(generator::function fn) : generator_{new generator(fn)} {}
   // See B1 README for explanation of the role of BuildForMaster in multi-threaded mode.
-  // As nain4 recommend avoiding multithreaded G4, implementing this has the lowest priority
-  //void BuildForMaster() const override;
+  // The master only gets a plain run action, which resets and reports the instrumentation.
+  void BuildForMaster() const override;
   void Build() const override;
 
   actions* set(G4UserRunAction     * a) { run_   = a; return this; }
@@ -130,15 +179,41 @@ private:
   G4UserStackingAction         * stack_ = nullptr;
 };
 
+// ----- actions_per_thread ---------------------------------------------------------
+// Builds a separate set of actions for each thread, by calling `build` the first
+// time Geant4 asks a thread for its actions: once in sequential mode, once for
+// the master and once per worker in multi-threaded mode. run_manager wraps the
+// functions given to `.actions(...)` in one of these, so that workers never
+// share action objects. Later requests from the same thread (after
+// replace_geometry, for instance) reuse the actions built for it.
+struct actions_per_thread : public G4VUserActionInitialization {
+  using build_fn = std::function<G4VUserActionInitialization* ()>;
+  actions_per_thread(build_fn build) : build{build} {}
+  void BuildForMaster() const override;
+  void Build() const override;
+private:
+  G4VUserActionInitialization* for_this_thread() const;
+  build_fn build;
+  mutable std::mutex mutex;
+  mutable std::map<G4int, std::unique_ptr<G4VUserActionInitialization>> built;
+};
+
 // ----- geometry -------------------------------------------------------------------
 // Quickly implement G4VUserDetectorConstruction: just instantiate this class
-// with a function which returns the geometry
+// with a function which returns the geometry.
+// The function runs only on the master thread, so the sensitive detectors it
+// attaches to logical volumes never reach the worker threads. Each worker
+// gets its own copy of them, made with G4VSensitiveDetector::Clone, which
+// n4::sensitive_detector and n4::photodetector implement: detectors of other
+// types need to implement it too, to be used with --threads.
 struct geometry : public G4VUserDetectorConstruction {
   using construct_fn = std::function<G4VPhysicalVolume* ()>;
   geometry(construct_fn f) : construct{f} {}
-  G4VPhysicalVolume* Construct() override { return construct(); }
+  G4VPhysicalVolume* Construct() override;
+  void ConstructSDandField() override;
 private:
   construct_fn construct;
+  std::vector<std::pair<G4LogicalVolume*, G4VSensitiveDetector*>> detectors; // attached on the master
 };
 
 // --------------------------------------------------------------------------------
@@ -1,11 +1,20 @@
 #include <n4-material.hh>
 
+#include <map>
+
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 
 namespace nain4 {
 
+void fast_lookup(G4MaterialPropertiesTable* table) {
+  // Includes GROUPVEL, which G4 derives from RINDEX
+  for (auto const& key : table -> GetMaterialPropertyNames()) {
+    if (auto property = table -> GetProperty(key)) { property -> EnableLogBinSearch(); }
+  }
+}
+
 material_properties& material_properties::add(G4String const& key, vec const& energies, vec const& values) {
   table -> AddProperty(key, energies, values); // es-vs size equality assertion done in AddProperty
   return *this;
@@ -93,6 +102,40 @@ material_properties& material_properties::copy_NEW_from(
   return *this;
 }
 
+// --------------------------------------------------------------------------------
+
+namespace {
+struct lazy_material {
+  nain4::material_builder build;
+  G4Material*             built    = nullptr;
+  bool                    building = false;
+};
+
+std::map<G4String, lazy_material>& lazy_materials() {
+  static std::map<G4String, lazy_material> registry;
+  return registry;
+}
+} // namespace
+
+void define_material(G4String const& name, material_builder build) {
+  lazy_materials()[name] = {std::move(build)};
+}
+
+G4Material* material(G4String const& name) {
+  auto& registry = lazy_materials();
+  auto found = registry.find(name);
+  if (found != registry.end() && ! found -> second.building) {
+    auto& lazy = found -> second;
+    if (! lazy.built) {
+      lazy.building = true;
+      lazy.built    = lazy.build();
+      lazy.building = false;
+    }
+    return lazy.built;
+  }
+  return G4NistManager::Instance()->FindOrBuildMaterial(name);
+}
+
 } // namespace nain4
 
 #pragma GCC diagnostic pop
@@ -6,6 +6,11 @@
 #include <G4NistManager.hh>
 #include <G4Types.hh>
 
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #pragma GCC diagnostic push
@@ -15,6 +20,13 @@ namespace nain4 {
 // --------------------------------------------------------------------------------
 // definition of material properties
 
+// Make every vector property in `table` find the bin of an energy through a
+// uniform grid over log(energy), built once here, rather than by binary search
+// over its nodes (G4PhysicsFreeVector::EnableLogBinSearch). Lookups during
+// tracking then take constant time. Vectors with fewer than 3 nodes are left
+// as they are, and so are properties added to `table` afterwards.
+void fast_lookup(G4MaterialPropertiesTable* table);
+
 class material_properties {
   using vec = std::vector<G4double>;
 public:
@@ -33,14 +45,35 @@ public:
   material_properties& copy_NEW_from(G4MaterialPropertiesTable const * const other, std::initializer_list<std::string> const& keys);
   material_properties& copy_from    (G4MaterialPropertiesTable const * const other,             std::string  const& key );
   material_properties& copy_NEW_from(G4MaterialPropertiesTable const * const other,             std::string  const& key );
-  G4MaterialPropertiesTable* done() { return table; }
+  // Apply n4::fast_lookup to the table in `done`
+  material_properties& fast_lookup() { fast = true; return *this; }
+  G4MaterialPropertiesTable* done() { if (fast) { nain4::fast_lookup(table); } return table; }
 private:
   G4MaterialPropertiesTable* table = new G4MaterialPropertiesTable;
+  bool                       fast  = false;
 };
 
 // --------------------------------------------------------------------------------
 
-inline auto material (G4String const& name){ return G4NistManager::Instance()->FindOrBuildMaterial(name); }
+// Materials defined with define_material are built by n4::material the first
+// time their name is requested, and never again. Any other name is looked up
+// in the G4 material table and the NIST database. Inside `build`, the name
+// being defined refers to the NIST material, so
+//
+//   n4::define_material("G4_AIR", [] {
+//     auto air = n4::material("G4_AIR");
+//     air -> SetMaterialPropertiesTable(...);
+//     return air;
+//   });
+//
+// decorates G4_AIR on first use. This changes what n4::material("G4_AIR")
+// returns for the rest of the program, so define materials explicitly in
+// main, before building the geometry, rather than as a side effect of static
+// initialization.
+using material_builder = std::function<G4Material*()>;
+void define_material(G4String const& name, material_builder build);
+
+G4Material* material(G4String const& name);
 inline auto element  (G4String const& name){ return G4NistManager::Instance()->FindOrBuildElement (name); }
 
 // An element identifier + element count.
@@ -111,6 +144,106 @@ G4Material* material_from_elements_F(std::string name, G4double density, materia
 }
 
 
+
+// --------------------------------------------------------------------------------
+// Compile-time material descriptions
+//
+//   constexpr auto fr4 = n4::material_spec_N("FR4", 1.86*g/cm3, {{"C", 15}, {"H", 44}, {"O", 7}});
+//   G4Material* m = n4::material_from<fr4>();
+//
+// Element symbols, counts and mass fractions are checked by the compiler. The
+// G4Material is built the first time material_from is called and cached: later
+// calls involve no string lookups or allocations.
+
+namespace internal {
+// Indexed by atomic number
+constexpr std::array<std::string_view, 109> element_symbols {
+  ""  ,
+  "H" , "He", "Li", "Be", "B" , "C" , "N" , "O" , "F" , "Ne", "Na", "Mg", "Al", "Si", "P" , "S" ,
+  "Cl", "Ar", "K" , "Ca", "Sc", "Ti", "V" , "Cr", "Mn", "Fe", "Co", "Ni", "Cu", "Zn", "Ga", "Ge",
+  "As", "Se", "Br", "Kr", "Rb", "Sr", "Y" , "Zr", "Nb", "Mo", "Tc", "Ru", "Rh", "Pd", "Ag", "Cd",
+  "In", "Sn", "Sb", "Te", "I" , "Xe", "Cs", "Ba", "La", "Ce", "Pr", "Nd", "Pm", "Sm", "Eu", "Gd",
+  "Tb", "Dy", "Ho", "Er", "Tm", "Yb", "Lu", "Hf", "Ta", "W" , "Re", "Os", "Ir", "Pt", "Au", "Hg",
+  "Tl", "Pb", "Bi", "Po", "At", "Rn", "Fr", "Ra", "Ac", "Th", "Pa", "U" , "Np", "Pu", "Am", "Cm",
+  "Bk", "Cf", "Es", "Fm", "Md", "No", "Lr", "Rf", "Db", "Sg", "Bh", "Hs"
+};
+
+consteval G4int atomic_number(std::string_view symbol) {
+  for (size_t z=1; z<element_symbols.size(); z++) {
+    if (element_symbols[z] == symbol) { return static_cast<G4int>(z); }
+  }
+  throw "n4::material_spec: unknown element symbol";
+}
+} // namespace internal
+
+template<class AMOUNT> struct element_amount { std::string_view symbol; AMOUNT amount; };
+
+template<class AMOUNT, size_t N>
+struct material_spec {
+  std::string_view      name;
+  G4double              density;
+  std::array<G4int , N> z;
+  std::array<AMOUNT, N> amount;
+  material_options      options;
+};
+
+template<class AMOUNT, size_t N>
+consteval auto make_material_spec(std::string_view name, G4double density,
+                                  element_amount<AMOUNT> const (&components)[N],
+                                  material_options const& opts) {
+  if (name.empty())  { throw "n4::material_spec: the material needs a name"; }
+  if (density <= 0)  { throw "n4::material_spec: density must be positive"; }
+
+  material_spec<AMOUNT, N> spec{name, density, {}, {}, opts};
+  for (size_t i=0; i<N; i++) {
+    spec.z     [i] = internal::atomic_number(components[i].symbol);
+    spec.amount[i] = components[i].amount;
+    if (components[i].amount <= 0) { throw "n4::material_spec: element amounts must be positive"; }
+    for (size_t j=0; j<i; j++) {
+      if (spec.z[j] == spec.z[i]) { throw "n4::material_spec: element appears more than once"; }
+    }
+  }
+  return spec;
+}
+
+// By number of atoms per molecule
+template<size_t N>
+consteval auto material_spec_N(std::string_view name, G4double density,
+                               element_amount<G4int> const (&components)[N],
+                               material_options const& opts = {}) {
+  return make_material_spec(name, density, components, opts);
+}
+
+// By mass fraction: fractions must add up to 1
+template<size_t N>
+consteval auto material_spec_F(std::string_view name, G4double density,
+                               element_amount<G4double> const (&components)[N],
+                               material_options const& opts = {}) {
+  auto spec  = make_material_spec(name, density, components, opts);
+  auto total = 0.0;
+  for (auto f : spec.amount) { total += f; }
+  if (total < 1 - 1e-9 || total > 1 + 1e-9) { throw "n4::material_spec: mass fractions must add up to 1"; }
+  return spec;
+}
+
+template<auto const& SPEC>
+G4Material* material_from() {
+  static G4Material* const cached = [] {
+    G4String name{SPEC.name};
+    if (auto existing = G4Material::GetMaterial(name, false)) { return existing; }
+
+    auto const& opts = SPEC.options;
+    auto n           = static_cast<G4int>(SPEC.z.size());
+    auto nist        = G4NistManager::Instance();
+    auto material    = new G4Material{name, SPEC.density, n, opts.state, opts.temp, opts.pressure};
+    for (size_t i=0; i<SPEC.z.size(); i++) {
+      material -> AddElement(nist -> FindOrBuildElement(SPEC.z[i]), SPEC.amount[i]);
+    }
+    return material;
+  }();
+  return cached;
+}
+
 } // namespace nain4
 
 namespace n4 { using namespace nain4; }
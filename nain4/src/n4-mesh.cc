@@ -0,0 +1,246 @@
+#include <n4-mesh.hh>
+#include <n4-exceptions.hh>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+namespace {
+
+// ---- Read-only memory map of a whole file, unmapped on destruction ---------------------------------
+struct mapped_file {
+  mapped_file(const std::string& path, const std::string& from) {
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) { throw exceptions::not_found(from, "Cannot open mesh file '" + path + "'"); }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      size = static_cast<size_t>(info.st_size);
+      auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data = static_cast<const char*>(addr);
+        madvise(addr, size, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+    if (! data) { throw exceptions::parse_error(from, "Cannot map mesh file '" + path + "' (empty?)"); }
+  }
+  ~mapped_file() { munmap(const_cast<char*>(data), size); }
+  mapped_file(const mapped_file&) = delete;
+
+  std::string_view contents() const { return {data, size}; }
+
+  const char* data = nullptr;
+  size_t      size = 0;
+};
+
+// ---- Merges coincident vertices, keyed on their exact coordinates ----------------------------------
+struct vertex_index {
+  using key = std::array<double, 3>;
+  struct hash {
+    size_t operator()(const key& k) const {
+      size_t h = 0xcbf29ce484222325ull;
+      for (auto x : k) { h = (h ^ std::bit_cast<uint64_t>(x)) * 0x100000001b3ull; h ^= h >> 29; }
+      return h;
+    }
+  };
+
+  vertex_index(mesh& m, G4double unit, size_t expected) : m{m}, unit{unit} {
+    m.vertices.reserve(expected);
+    index     .reserve(expected);
+  }
+
+  size_t operator()(double x, double y, double z) {
+    // Adding 0 turns -0 into +0, so that they are merged
+    auto [it, inserted] = index.try_emplace(key{x + 0., y + 0., z + 0.}, m.vertices.size());
+    if (inserted) { m.vertices.emplace_back(x * unit, y * unit, z * unit); }
+    return it -> second;
+  }
+
+  // Triangles which collapsed onto a line or point are dropped
+  void triangle(size_t a, size_t b, size_t c) {
+    if (a == b || b == c || c == a) { return; }
+    m.triangles.push_back({a, b, c});
+  }
+
+private:
+  mesh&                                   m;
+  G4double                                unit;
+  std::unordered_map<key, size_t, hash>   index;
+};
+
+// ---- Minimal cursor over text ----------------------------------------------------------------------
+struct cursor {
+  const char* here;
+  const char* end;
+  const std::string& from;
+
+  bool done() const { return here >= end; }
+  void skip_blanks() { while (here < end && (*here == ' ' || *here == '\t' || *here == '\r')) { here++; } }
+  void skip_space () { while (here < end && std::isspace(static_cast<unsigned char>(*here))) { here++; } }
+  void skip_line  () { while (here < end && *here != '\n') { here++; } if (here < end) { here++; } }
+
+  std::string_view word() {
+    skip_space();
+    auto start = here;
+    while (here < end && ! std::isspace(static_cast<unsigned char>(*here))) { here++; }
+    return {start, static_cast<size_t>(here - start)};
+  }
+
+  double number() {
+    skip_space();
+    if (here < end && *here == '+') { here++; }
+    double x;
+    auto [ptr, ec] = std::from_chars(here, end, x);
+    if (ec != std::errc{}) { fail("expected a number"); }
+    here = ptr;
+    return x;
+  }
+
+  [[noreturn]] void fail(const std::string& what) const {
+    auto context = std::string{here, std::min<size_t>(end - here, 40)};
+    throw exceptions::parse_error(from, what + ", found: '" + context + "'");
+  }
+};
+
+bool ends_with_ci(std::string s, std::string suffix) {
+  std::transform(begin(s), end(s), begin(s), [] (unsigned char c) { return std::tolower(c); });
+  return s.ends_with(suffix);
+}
+
+mesh read_binary_stl(std::string_view data, G4double unit) {
+  uint32_t n_triangles;
+  std::memcpy(&n_triangles, data.data() + 80, sizeof(n_triangles));
+
+  mesh m;
+  m.triangles.reserve(n_triangles);
+  // Closed triangulated surfaces have about half as many vertices as triangles
+  vertex_index vertex{m, unit, n_triangles / 2 + 3};
+
+  auto record = data.data() + 84;
+  for (uint32_t t=0; t<n_triangles; t++, record += 50) {
+    float xyz[9];
+    std::memcpy(xyz, record + 12, sizeof(xyz)); // skip the normal; STL is little-endian
+    vertex.triangle(vertex(xyz[0], xyz[1], xyz[2]),
+                    vertex(xyz[3], xyz[4], xyz[5]),
+                    vertex(xyz[6], xyz[7], xyz[8]));
+  }
+  return m;
+}
+
+mesh read_ascii_stl(std::string_view data, G4double unit, const std::string& from) {
+  mesh m;
+  // Each facet takes roughly 250 bytes of text
+  vertex_index vertex{m, unit, data.size() / 500 + 3};
+  cursor in{data.data(), data.data() + data.size(), from};
+
+  size_t corners[3];
+  int    n = 0;
+  while (! in.done()) {
+    auto word = in.word();
+    if (word == "vertex") {
+      if (n == 3) { in.fail("more than 3 vertices in a facet"); }
+      auto x = in.number(), y = in.number(), z = in.number();
+      corners[n++] = vertex(x, y, z);
+    }
+    else if (word == "endloop") {
+      if (n != 3) { in.fail("facet without 3 vertices"); }
+      vertex.triangle(corners[0], corners[1], corners[2]);
+      n = 0;
+    }
+  }
+  return m;
+}
+
+} // anonymous namespace
+
+mesh read_stl(const std::string& path, G4double unit) {
+  auto from = "n4::read_stl(" + path + ")";
+  mapped_file file{path, from};
+  auto data = file.contents();
+
+  // Some exporters write binary files whose header starts with "solid", so the
+  // size implied by the triangle count is a more reliable test than the header.
+  if (data.size() >= 84) {
+    uint32_t n_triangles;
+    std::memcpy(&n_triangles, data.data() + 80, sizeof(n_triangles));
+    if (data.size() == 84 + 50 * static_cast<size_t>(n_triangles)) { return read_binary_stl(data, unit); }
+  }
+
+  auto start = data.find_first_not_of(" \t\r\n");
+  if (start == data.npos || data.substr(start, 5) != "solid") {
+    throw exceptions::parse_error(from, "Neither a binary nor an ASCII STL file");
+  }
+  return read_ascii_stl(data, unit, from);
+}
+
+mesh read_obj(const std::string& path, G4double unit) {
+  auto from = "n4::read_obj(" + path + ")";
+  mapped_file file{path, from};
+  auto data = file.contents();
+
+  mesh m;
+  vertex_index vertex{m, unit, data.size() / 60 + 3};
+  std::vector<size_t> merged; // OBJ index (0-based) -> merged vertex
+  std::vector<size_t> face;
+  cursor in{data.data(), data.data() + data.size(), from};
+
+  while (! in.done()) {
+    in.skip_space();
+    if (in.done()) { break; }
+    auto start = in.here;
+    auto word  = in.word();
+
+    if (word == "v") {
+      auto x = in.number(), y = in.number(), z = in.number();
+      merged.push_back(vertex(x, y, z));
+      in.skip_line(); // optional w or vertex colours
+    }
+    else if (word == "f") {
+      face.clear();
+      // Each corner is i, i/j, i//k or i/j/k; only i matters. Negative
+      // indices count backwards from the last vertex read.
+      for (in.skip_blanks(); ! in.done() && *in.here != '\n'; in.skip_blanks()) {
+        long i;
+        auto [ptr, ec] = std::from_chars(in.here, in.end, i);
+        if (ec != std::errc{}) { in.fail("expected a vertex index"); }
+        in.here = ptr;
+        while (! in.done() && ! std::isspace(static_cast<unsigned char>(*in.here))) { in.here++; }
+
+        auto n = static_cast<long>(merged.size());
+        auto k = i > 0 ? i - 1 : n + i;
+        if (i == 0 || k < 0 || k >= n) { in.here = start; in.fail("vertex index out of range"); }
+        face.push_back(merged[k]);
+      }
+      if (face.size() < 3) { in.here = start; in.fail("face with fewer than 3 vertices"); }
+      // Faces are convex polygons: triangulate as a fan
+      for (size_t c=1; c+1<face.size(); c++) { vertex.triangle(face[0], face[c], face[c+1]); }
+    }
+    else { in.skip_line(); } // comments, normals, texture coordinates, groups, materials ...
+  }
+  return m;
+}
+
+mesh read_mesh(const std::string& path, G4double unit) {
+  if (ends_with_ci(path, ".stl")) { return read_stl(path, unit); }
+  if (ends_with_ci(path, ".obj")) { return read_obj(path, unit); }
+  throw exceptions::parse_error("n4::read_mesh(" + path + ")", "Unknown mesh format: use .stl or .obj");
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
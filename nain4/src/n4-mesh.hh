@@ -0,0 +1,38 @@
+#pragma once
+
+#include <G4SystemOfUnits.hh>
+#include <G4ThreeVector.hh>
+#include <G4Types.hh>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- Triangle meshes, as read from CAD exports -----------------------------------------------------
+// Vertices are shared between triangles: coincident vertices in the input are
+// merged while reading. Triangles list vertex indices anticlockwise when seen
+// from outside, which is the convention of STL, OBJ and G4TessellatedSolid.
+struct mesh {
+  std::vector<G4ThreeVector>         vertices;
+  std::vector<std::array<size_t, 3>> triangles;
+};
+
+// Files are memory-mapped and parsed in a single pass. Coordinates are
+// multiplied by `unit`, as CAD formats carry no units of their own.
+// Errors are reported with n4::exceptions::not_found (file cannot be opened)
+// and n4::exceptions::parse_error (malformed contents).
+mesh read_stl (const std::string& path, G4double unit = CLHEP::mm); // ASCII or binary
+mesh read_obj (const std::string& path, G4double unit = CLHEP::mm);
+mesh read_mesh(const std::string& path, G4double unit = CLHEP::mm); // dispatch on extension
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
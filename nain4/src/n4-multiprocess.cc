@@ -0,0 +1,193 @@
+#include <n4-multiprocess.hh>
+
+#include <G4RunManager.hh>
+#include <G4ios.hh>
+#include <Randomize.hh>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace fs = std::filesystem;
+
+namespace nain4 {
+namespace multiprocess {
+
+namespace {
+
+struct named_accumulator {
+  std::string           name;
+  save_fn               save;
+  merge_fn              merge;
+  std::function<void()> before_fork;
+};
+
+bool                    enabled_     = false;
+unsigned                processes_   = 1;
+std::optional<unsigned> worker_;
+size_t                  first_event_ = 0;
+
+std::vector<named_accumulator>              accumulators_;
+std::vector<std::pair<std::string, size_t>> output_files_; // path, header lines
+
+[[noreturn]] void fail(std::string const& message) {
+  std::cerr << "n4::multiprocess: " << message << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+std::string path_for_worker(std::string const& path, unsigned worker) {
+  return path + ".process-" + std::to_string(worker);
+}
+
+fs::path accumulator_file(fs::path const& dir, std::string const& name, unsigned worker) {
+  return dir / (name + "-" + std::to_string(worker));
+}
+
+[[noreturn]] void work(unsigned worker, size_t first, G4int events, long const* seeds,
+                       fs::path const& dir, std::function<void(G4int)> const& beam_on) {
+  worker_      = worker;
+  first_event_ = first;
+  G4Random::setTheSeeds(seeds);
+  beam_on(events);
+
+  for (auto& a : accumulators_) {
+    std::ofstream out{accumulator_file(dir, a.name, worker), std::ios::binary};
+    a.save(out);
+    if (! out) { std::cerr << "n4::multiprocess: cannot save accumulator '" << a.name << "'" << std::endl; _exit(EXIT_FAILURE); }
+  }
+  G4cout << std::flush;
+  std::cout.flush();
+  std::fflush(nullptr);
+  // Leave without running destructors: they belong to the parent. Streams the
+  // user still has open are not flushed, see `output_path` in the header.
+  _exit(EXIT_SUCCESS);
+}
+
+void merge_output(std::string const& path, size_t header_lines) {
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  for (unsigned worker=0; worker<processes_; worker++) {
+    auto part = path_for_worker(path, worker);
+    if (! fs::exists(part)) { continue; }
+    {
+      std::ifstream in{part, std::ios::binary};
+      if (worker > 0) {
+        std::string skip;
+        for (size_t i=0; i<header_lines && std::getline(in, skip); i++) {}
+      }
+      if (in.peek() != std::ifstream::traits_type::eof()) { out << in.rdbuf(); }
+    }
+    fs::remove(part);
+  }
+  if (! out) { fail("cannot write " + path); }
+}
+
+} // anonymous namespace
+
+void switch_on(unsigned processes) {
+  if (processes == 0) { fail("the number of processes must be positive"); }
+  enabled_   = true;
+  processes_ = processes;
+}
+
+void switch_off() {
+  enabled_ = false;
+  accumulators_.clear();
+  output_files_.clear();
+}
+
+bool enabled() { return enabled_; }
+
+void accumulator(std::string const& name, save_fn save, merge_fn merge, std::function<void()> before_fork) {
+  auto same_name = [&name] (auto const& a) { return a.name == name; };
+  accumulators_.erase(std::remove_if(begin(accumulators_), end(accumulators_), same_name), end(accumulators_));
+  accumulators_.push_back({name, save, merge, before_fork});
+}
+
+void output_file(std::string const& path, size_t header_lines) {
+  auto same_path = [&path] (auto const& o) { return o.first == path; };
+  output_files_.erase(std::remove_if(begin(output_files_), end(output_files_), same_path), end(output_files_));
+  output_files_.emplace_back(path, header_lines);
+}
+
+std::string output_path(std::string const& path) {
+  return worker_.has_value() ? path_for_worker(path, worker_.value()) : path;
+}
+
+size_t first_event() { return first_event_; }
+
+void run(G4int events, std::function<void(G4int)> beam_on) {
+  if (G4RunManager::GetRunManager() -> GetRunManagerType() != G4RunManager::sequentialRM) {
+    fail("worker processes need a sequential run manager");
+  }
+
+  // Build the physics tables before forking, so that they are shared
+  beam_on(0);
+
+  // Independent seeds for each worker, as G4MTRunManager does for threads
+  std::vector<long> seeds;
+  for (unsigned worker=0; worker<processes_; worker++) {
+    seeds.push_back(static_cast<long>(100'000'000L * G4UniformRand()));
+    seeds.push_back(static_cast<long>(100'000'000L * G4UniformRand()));
+    seeds.push_back(0); // terminates the seeds of each worker
+  }
+
+  for (auto& a : accumulators_) { if (a.before_fork) { a.before_fork(); } }
+
+  auto dir = fs::temp_directory_path() / ("n4-multiprocess-" + std::to_string(getpid()));
+  fs::create_directories(dir);
+  G4cout << std::flush;
+  std::cout.flush();
+
+  auto requested = static_cast<size_t>(std::max(events, 0));
+  std::vector<pid_t> workers;
+  size_t first = 0;
+  for (unsigned worker=0; worker<processes_; worker++) {
+    auto n   = requested / processes_ + (worker < requested % processes_ ? 1 : 0);
+    auto pid = fork();
+    if (pid <  0) { fail("cannot fork worker process"); }
+    if (pid == 0) { work(worker, first, static_cast<G4int>(n), &seeds[3 * worker], dir, beam_on); }
+    workers.push_back(pid);
+    first += n;
+  }
+
+  auto failed = 0u;
+  for (auto pid : workers) {
+    int   status;
+    pid_t done;
+    do { done = waitpid(pid, &status, 0); } while (done < 0 && errno == EINTR);
+    if (done < 0 || ! WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) { failed++; }
+  }
+  if (failed) {
+    fs::remove_all(dir);
+    fail(std::to_string(failed) + " of " + std::to_string(processes_) + " worker processes failed");
+  }
+
+  for (unsigned worker=0; worker<processes_; worker++) {
+    for (auto& a : accumulators_) {
+      std::ifstream in{accumulator_file(dir, a.name, worker), std::ios::binary};
+      if (! in) { fail("no accumulator '" + a.name + "' from worker " + std::to_string(worker)); }
+      a.merge(in);
+    }
+  }
+  for (auto& [path, header_lines] : output_files_) { merge_output(path, header_lines); }
+  fs::remove_all(dir);
+}
+
+} // namespace multiprocess
+} // namespace nain4
+
+#pragma GCC diagnostic pop
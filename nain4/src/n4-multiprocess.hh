@@ -0,0 +1,76 @@
+#pragma once
+
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace multiprocess {
+
+// ---- Share the events of a run among forked processes ------------------------------------------------
+// Off by default. Switch on (or pass --processes K on the CLI) to make
+// ui::run build the physics tables with an empty run and then fork K worker
+// processes, which share the geometry and physics copy-on-write. Each worker
+// simulates a disjoint range of the requested events with its own random
+// seeds, drawn from the engine of the parent (so --seed makes the whole run
+// reproducible). When all workers are done, the parent merges
+//  - the accumulators registered with `accumulator`,
+//  - the output files registered with `output_file`, which each worker
+//    writes to the path given by `output_path`.
+// Needs a sequential run manager: do not combine with --threads. Cannot be
+// combined with --benchmark or --checkpoint either.
+void switch_on (unsigned processes);
+void switch_off(); // also forgets the accumulators and output files
+bool enabled   ();
+
+// How to ship the state of an accumulator from the workers to the parent:
+// the worker calls `save`, and the parent calls `merge` once per worker.
+// `before_fork` is called in the parent just before forking.
+using save_fn  = std::function<void (std::ostream&)>;
+using merge_fn = std::function<void (std::istream&)>;
+void accumulator(std::string const& name, save_fn save, merge_fn merge, std::function<void()> before_fork = {});
+
+// Numbers are summed: the parent gains whatever each worker added to its copy
+template<class T>
+void accumulator(std::string const& name, T& value) {
+  static_assert(std::is_arithmetic_v<T>, "n4::multiprocess::accumulator needs save and merge functions for this type");
+  auto at_fork = std::make_shared<T>();
+  accumulator(name,
+              [&value, at_fork] (std::ostream& out) { T added = value - *at_fork; out.write(reinterpret_cast<char const*>(&added), sizeof(T)); },
+              [&value         ] (std::istream& in ) { T added;                    in .read (reinterpret_cast<char      *>(&added), sizeof(T)); value += added; },
+              [&value, at_fork] ()                  { *at_fork = value; });
+}
+
+// The workers' files are concatenated in order of their event ranges,
+// keeping the first `header_lines` lines only from the first worker.
+void output_file(std::string const& path, size_t header_lines = 0);
+// Where this process should write `path`: a file of its own in the workers.
+// Workers leave with _exit, which does not flush C++ streams: open the file
+// in BeginOfRunAction and close it in EndOfRunAction, or whatever was still
+// buffered is lost.
+std::string output_path(std::string const& path);
+
+// Number of events before the range of this worker (0 outside workers).
+// Event IDs start from 0 in every worker: add this to get IDs which are
+// unique across the whole run. With n4::sub_events, add it to
+// sub_events::event_of instead.
+size_t first_event();
+
+// Hook called by ui::run
+void run(G4int events, std::function<void(G4int)> beam_on);
+
+} // namespace multiprocess
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,67 @@
+#include <n4-optical-stacking.hh>
+#include <n4-random.hh>
+
+#include <G4OpticalPhoton.hh>
+#include <G4StackManager.hh>
+
+#include <iostream>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+optical_stacking::optical_stacking() {
+  classify([this] (G4Track const* track) {
+    if (track -> GetDefinition() == G4OpticalPhoton::Definition()) { return classify_optical(track); }
+    return others_ ? others_(track) : fUrgent;
+  });
+  next_stage([this] (G4StackManager* const stack) {
+    // The waiting stack has just been moved to the urgent one
+    auto optical = waiting_ > 0;
+    waiting_ = 0;
+    if (optical && optical_stage_) { optical_stage_(stack); }
+  });
+  next_event([this] {
+    counts_  = {};
+    waiting_ = 0;
+  });
+}
+
+optical_stacking* optical_stacking::sample(G4double fraction) {
+  if (! (0 < fraction && fraction <= 1)) {
+    std::cerr << "n4::optical_stacking::sample: fraction must be in (0, 1], got " << fraction << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  fraction_ = fraction;
+  return this;
+}
+
+optical_stacking* optical_stacking::defer(size_t max_waiting) {
+  defer_       = true;
+  max_waiting_ = max_waiting;
+  return this;
+}
+
+G4ClassificationOfNewTrack optical_stacking::classify_optical(G4Track const* track) {
+  counts_.created++;
+  if (drop_) { counts_.dropped++; return fKill; }
+
+  if (fraction_ < 1) {
+    if (! random::biased_coin(fraction_)) { counts_.dropped++; return fKill; }
+    // G4 hands us a const track, but the weight is ours to adjust before it is stacked
+    auto mutable_track = const_cast<G4Track*>(track);
+    mutable_track -> SetWeight(track -> GetWeight() / fraction_);
+  }
+
+  if (defer_ && waiting_ < max_waiting_) {
+    waiting_++;
+    counts_.deferred++;
+    return fWaiting;
+  }
+  return fUrgent;
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <n4-mandatory.hh>
+
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <limits>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// A stacking action which controls how optical photons reach the stack. By
+// default they are stacked like any other track. Each of the following can be
+// combined with the others:
+//
+// + sample(f): keep each photon with probability f, dividing its weight by f.
+//   Detectors must then count photons by weight (see photodetector::hit). This
+//   trades precision for throughput and stack memory.
+//
+// + defer(n): send photons to the waiting stack, so they are tracked in a
+//   separate stage after every other particle of the event. At most n are
+//   waiting at once; any more are tracked straight away, which bounds the
+//   memory used by the stack. optical_stage is called as they start.
+//
+// + drop(): kill every photon on creation, only counting them.
+//
+//   auto stacking = (new n4::optical_stacking)
+//     -> sample(0.1)
+//     -> defer(100'000);
+//   actions -> set(stacking);
+//
+// Non-optical tracks are classified by `others` (default: urgent).
+class optical_stacking : public stacking_action {
+public:
+  struct counts {
+    size_t created  = 0; // optical photons classified in this event
+    size_t dropped  = 0; // killed by drop or sample
+    size_t deferred = 0; // sent to the waiting stack
+  };
+
+  optical_stacking();
+
+  optical_stacking* sample       (G4double   fraction);
+  optical_stacking* defer        (size_t     max_waiting = std::numeric_limits<size_t>::max());
+  optical_stacking* drop         (                   ) { drop_         = true; return this; }
+  optical_stacking* optical_stage(stage_t    f       ) { optical_stage_ = f  ; return this; }
+  optical_stacking* others       (classify_t f       ) { others_        = f  ; return this; }
+
+  counts const& this_event() const { return counts_; }
+
+private:
+  G4ClassificationOfNewTrack classify_optical(G4Track const*);
+
+  G4double   fraction_      = 1;
+  bool       defer_         = false;
+  bool       drop_          = false;
+  size_t     max_waiting_   = 0;
+  size_t     waiting_       = 0;
+  stage_t    optical_stage_;
+  classify_t others_;
+  counts     counts_;
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,163 @@
+#include <n4-overlaps.hh>
+
+#include <G4AffineTransform.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VSolid.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+namespace {
+
+struct task {
+  G4VPhysicalVolume* daughter;
+  G4LogicalVolume*   mother;
+  G4VPhysicalVolume* mother_placement;
+};
+
+G4VPhysicalVolume* find_world() {
+  for (auto phys : *G4PhysicalVolumeStore::GetInstance()) {
+    if (! phys -> GetMotherLogical()) { return phys; }
+  }
+  return nullptr;
+}
+
+// One task per daughter of each distinct logical volume. Replicas and
+// parameterised volumes are skipped, as in G4PVPlacement::CheckOverlaps.
+std::vector<task> collect_tasks(G4VPhysicalVolume* world) {
+  std::vector<task> tasks;
+  std::set<G4LogicalVolume*> seen;
+  std::vector<G4VPhysicalVolume*> pending{world};
+  while (! pending.empty()) {
+    auto mother_placement = pending.back(); pending.pop_back();
+    auto mother = mother_placement -> GetLogicalVolume();
+    if (! seen.insert(mother).second) { continue; }
+    for (size_t i=0; i<mother -> GetNoDaughters(); i++) {
+      auto daughter = mother -> GetDaughter(i);
+      pending.push_back(daughter);
+      if (daughter -> IsReplicated()) { continue; }
+      tasks.push_back({daughter, mother, mother_placement});
+    }
+  }
+  return tasks;
+}
+
+G4AffineTransform placement_of(G4VPhysicalVolume* phys) {
+  return {phys -> GetRotation(), phys -> GetTranslation()};
+}
+
+// Many solids build internal tables the first time a point is sampled on
+// their surface. Doing this serially avoids racing on those lazy caches.
+void warm_up(const std::vector<task>& tasks) {
+  std::set<G4VSolid*> solids;
+  for (auto& t : tasks) {
+    solids.insert(t.daughter -> GetLogicalVolume() -> GetSolid());
+    solids.insert(t.mother                         -> GetSolid());
+  }
+  for (auto solid : solids) { solid -> GetPointOnSurface(); }
+}
+
+void check_one(const task& t, unsigned n_points, G4double tolerance, std::vector<overlap>& found) {
+  auto solid        = t.daughter -> GetLogicalVolume() -> GetSolid();
+  auto mother_solid = t.mother                         -> GetSolid();
+  auto transform    = placement_of(t.daughter);
+
+  std::vector<std::pair<G4VPhysicalVolume*, G4AffineTransform>> siblings;
+  for (size_t i=0; i<t.mother -> GetNoDaughters(); i++) {
+    auto sibling = t.mother -> GetDaughter(i);
+    if (sibling == t.daughter || sibling -> IsReplicated()) { continue; }
+    siblings.emplace_back(sibling, placement_of(sibling));
+  }
+
+  // Keep only the deepest point for each offending pair
+  std::map<G4VPhysicalVolume*, overlap> worst;
+  auto record = [&] (G4VPhysicalVolume* other, overlap::problem kind, G4double depth, const G4ThreeVector& point) {
+    auto [it, inserted] = worst.try_emplace(other, overlap{t.daughter, other, kind, depth, point});
+    if (! inserted && depth > it -> second.depth) { it -> second.depth = depth; it -> second.point = point; }
+  };
+
+  for (unsigned n=0; n<n_points; n++) {
+    auto point = transform.TransformPoint(solid -> GetPointOnSurface());
+
+    if (mother_solid -> Inside(point) == kOutside) {
+      auto depth = mother_solid -> DistanceToIn(point);
+      if (depth > tolerance) { record(t.mother_placement, overlap::problem::protrusion, depth, point); }
+    }
+
+    for (auto& [sibling, sibling_transform] : siblings) {
+      auto local = sibling_transform.InverseTransformPoint(point);
+      auto other = sibling -> GetLogicalVolume() -> GetSolid();
+      if (other -> Inside(local) != kInside) { continue; }
+      auto depth = other -> DistanceToOut(local);
+      if (depth > tolerance) { record(sibling, overlap::problem::overlap, depth, point); }
+    }
+  }
+
+  for (auto& [_, o] : worst) { found.push_back(o); }
+}
+
+} // anonymous namespace
+
+std::vector<overlap> overlap_check::run(G4VPhysicalVolume* world) const {
+  if (! world) { world = find_world(); }
+  if (! world) { return {}; }
+
+  auto tasks = collect_tasks(world);
+  warm_up(tasks);
+
+  // One seed per task, drawn from the master engine, so that the points
+  // sampled on each volume do not depend on scheduling, and follow --seed
+  std::vector<long> seeds;
+  for (size_t i=0; i<tasks.size(); i++) { seeds.push_back(static_cast<long>(100'000'000L * G4UniformRand())); }
+
+  // Tasks are dealt out in a fixed order: some solids sample with their own
+  // thread-local generator, which cannot be reseeded per task
+  std::vector<std::vector<overlap>> found_by_task(tasks.size());
+  auto n = std::min<size_t>(std::max(1u, n_threads), tasks.size());
+  auto worker = [&] (size_t first) {
+    for (auto i = first; i < tasks.size(); i += n) {
+      G4Random::setTheSeed(seeds[i]);
+      check_one(tasks[i], n_points, tolerance_, found_by_task[i]);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t i=0; i<n; i++) { pool.emplace_back(worker, i); }
+  for (auto& thread : pool)  { thread.join(); }
+
+  std::vector<overlap> found;
+  for (auto& some : found_by_task) { found.insert(end(found), begin(some), end(some)); }
+  std::stable_sort(begin(found), end(found), [] (const auto& a, const auto& b) { return a.depth > b.depth; });
+  return found;
+}
+
+std::ostream& operator<<(std::ostream& out, const overlap& o) {
+  auto other = o.other ? o.other -> GetName() : G4String{"<unknown>"};
+  if (o.kind == overlap::problem::protrusion) { out << o.volume -> GetName() << " protrudes from mother " << other; }
+  else                                     { out << o.volume -> GetName() << " overlaps with "         << other; }
+  return out << " by " << o.depth / CLHEP::mm << " mm at " << o.point / CLHEP::mm << " mm (mother frame)";
+}
+
+size_t report_overlaps(std::ostream& out, const std::vector<overlap>& overlaps) {
+  if (overlaps.empty()) { out << "No overlaps found." << std::endl; }
+  else {
+    out << overlaps.size() << " overlap(s) found:" << std::endl;
+    for (auto& o : overlaps) { out << "  " << o << std::endl; }
+  }
+  return overlaps.size();
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <G4ThreeVector.hh>
+#include <G4Types.hh>
+
+#include <algorithm>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+class G4VPhysicalVolume;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- A single problem found by overlap_check -------------------------------------------------------
+// `volume` sticks out of its mother (`problem::protrusion`, `other` is the mother's
+// placement, if known) or into a sibling (`problem::overlap`, `other` is the sibling).
+// `depth` is the largest penetration found and `point` where it was found,
+// expressed in the mother's frame.
+struct overlap {
+  enum class problem { protrusion, overlap };
+  G4VPhysicalVolume* volume;
+  G4VPhysicalVolume* other;
+  problem            kind;
+  G4double           depth;
+  G4ThreeVector      point;
+};
+
+std::ostream& operator<<(std::ostream&, const overlap&);
+
+// ---- Overlap check over a finished geometry --------------------------------------------------------
+// Checks every daughter of every logical volume reachable from the world, in
+// parallel. Each logical volume is visited only once, regardless of how many
+// times it is placed. Points are sampled on the surface of each daughter and
+// tested against its mother and its siblings, just like G4PVPlacement::CheckOverlaps.
+//
+//   auto problems = n4::overlap_check().points(10'000).tolerance(1*um).run();
+//   n4::report_overlaps(std::cout, problems);
+//
+// Results are sorted by decreasing depth, with one entry per offending pair.
+// The points sampled on each volume are seeded from the master random engine,
+// so repeating a check with the same seed and threads gives the same results.
+struct overlap_check {
+  overlap_check& points   (unsigned n)   { n_points   = n; return *this; }
+  overlap_check& tolerance(G4double tol) { tolerance_ = tol; return *this; }
+  overlap_check& threads  (unsigned n)   { n_threads  = n; return *this; }
+
+  // world defaults to the only physical volume without a mother
+  std::vector<overlap> run(G4VPhysicalVolume* world = nullptr) const;
+
+private:
+  unsigned n_points   = 1000;
+  G4double tolerance_ = 0;
+  unsigned n_threads  = std::max(1u, std::thread::hardware_concurrency());
+};
+
+// Returns the number of problems reported
+size_t report_overlaps(std::ostream&, const std::vector<overlap>&);
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,110 @@
+#include <n4-photodetector.hh>
+#include <n4-random.hh>
+#include <n4-sensitive.hh>
+#include <n4-sub-events.hh>
+
+#include <G4EventManager.hh>
+#include <G4Run.hh>
+#include <G4RunManager.hh>
+#include <G4SDManager.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4VTouchable.hh>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+photodetector::photodetector(G4String name, std::vector<G4double> const& energies, std::vector<G4double> const& pde)
+: G4VSensitiveDetector{name}
+, energies{energies}
+, pdes{pde}
+{
+  auto increasing = std::adjacent_find(energies.begin(), energies.end(), std::greater_equal<>{}) == energies.end();
+  if (energies.size() != pde.size() || energies.size() < 2 || ! increasing) {
+    std::cerr << "n4::photodetector " << name << ": the PDE curve needs at least two points, "
+              << "with as many energies as efficiencies, in strictly increasing order of energy" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // With 4 cells per segment, an energy is almost always found in the first
+  // segment that overlaps its cell, or the next one
+  auto n_cells     = 4 * (energies.size() - 1);
+  cells_per_energy = n_cells / (energies.back() - energies.front());
+  first_segment.resize(n_cells);
+  size_t segment = 0;
+  for (size_t cell=0; cell<n_cells; cell++) {
+    auto lo = energies.front() + cell / cells_per_energy;
+    while (segment + 2 < energies.size() && energies[segment + 1] <= lo) { segment++; }
+    first_segment[cell] = segment;
+  }
+
+  fully_activate_sensitive_detector(this);
+}
+
+G4double photodetector::pde(G4double energy) const {
+  if (! (energies.front() <= energy && energy <= energies.back())) { return 0; }
+
+  auto cell    = std::min(static_cast<size_t>((energy - energies.front()) * cells_per_energy),
+                          first_segment.size() - 1);
+  auto segment = first_segment[cell];
+  while (segment + 2 < energies.size() && energies[segment + 1] < energy) { segment++; }
+
+  auto x0 = energies[segment], x1 = energies[segment + 1];
+  auto y0 = pdes    [segment], y1 = pdes    [segment + 1];
+  return y0 + (y1 - y0) / (x1 - x0) * (energy - x0);
+}
+
+G4VSensitiveDetector* photodetector::Clone() const {
+  auto clone = (new photodetector{GetName(), energies, pdes}) -> end_of_event(eoev);
+  clone -> merging = merging;
+  return clone;
+}
+
+bool photodetector::ProcessHits(G4Step* step, G4TouchableHistory*) {
+  step -> GetTrack() -> SetTrackStatus(fStopAndKill);
+
+  auto pre    = step -> GetPreStepPoint();
+  auto energy = pre  -> GetKineticEnergy();
+  if (random::uniform() < pde(energy)) {
+    buffer.push_back({pre -> GetTouchable() -> GetCopyNumber(), pre -> GetGlobalTime(), energy, pre -> GetWeight()});
+  }
+  return true;
+}
+
+void photodetector::EndOfEvent(G4HCofThisEvent*) {
+  if (! sub_events::enabled()) { eoev(buffer); return; }
+
+  auto part  = G4EventManager::GetEventManager() -> GetConstCurrentEvent();
+  auto event = sub_events::event_of(part);
+  auto run   = G4RunManager::GetRunManager() -> GetCurrentRun() -> GetRunID();
+
+  std::lock_guard<std::mutex> lock{merging -> mutex};
+  auto& parts = merging -> pending[event];
+  // The first part to finish arranges the merge: the entry may be left over
+  // from an aborted run
+  if (parts.hits.empty() || parts.run != run) {
+    parts = {run, std::vector<std::vector<hit>>(sub_events::parts())};
+    sub_events::when_done(part, [merging = merging, event, path = GetFullPathName()] {
+      std::vector<hit> all;
+      {
+        std::lock_guard<std::mutex> guard{merging -> mutex};
+        for (auto& hits_of_part : merging -> pending[event].hits) { all.insert(all.end(), hits_of_part.begin(), hits_of_part.end()); }
+        merging -> pending.erase(event);
+      }
+      // The copy of this detector in the thread which finished the last part
+      auto detector = static_cast<photodetector*>(G4SDManager::GetSDMpointer() -> FindSensitiveDetector(path));
+      detector -> eoev(all);
+    });
+  }
+  parts.hits[sub_events::part_of(part)] = buffer;
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
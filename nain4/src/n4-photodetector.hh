@@ -0,0 +1,82 @@
+#pragma once
+
+#include <G4VSensitiveDetector.hh>
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// A sensitive detector for photodetectors such as SiPMs or PMTs. Every
+// particle entering it is stopped; photons are detected with a probability
+// given by the photon detection efficiency (PDE) curve, interpolated linearly
+// between the given points, and zero outside them. The curve is indexed once,
+// on construction, so each photon costs a constant-time lookup and a random
+// number.
+//
+// Detected photons are collected in a buffer which is reused across events,
+// and handed to the end_of_event function:
+//
+//   auto sipm = (new n4::photodetector{"sipm", energies, pdes})
+//     -> end_of_event([&] (auto const& hits) { for (auto& hit : hits) { ... } });
+//
+// With --threads each worker has a copy of the detector, made with Clone,
+// which calls the same end_of_event function: it must be thread-safe.
+//
+// With n4::sub_events, end_of_event is called once per requested event, with
+// the hits of all its parts, by the copy of the detector in the thread which
+// finishes the last of them.
+class photodetector : public G4VSensitiveDetector {
+public:
+  struct hit {
+    G4int    copy_no;
+    G4double time;
+    G4double energy;
+    G4double weight; // above 1 when photons are sampled: see n4::optical_stacking
+  };
+  using end_of_event_fn = std::function<void(std::vector<hit> const&)>;
+
+  photodetector(G4String name, std::vector<G4double> const& energies, std::vector<G4double> const& pde);
+
+  photodetector* end_of_event(end_of_event_fn f) { eoev = f; return this; }
+
+  G4double                pde (G4double energy) const;
+  std::vector<hit> const& hits()                const { return buffer; }
+
+  G4VSensitiveDetector* Clone() const override;
+
+  bool ProcessHits(G4Step* step, G4TouchableHistory*) override;
+  void Initialize (G4HCofThisEvent*)                  override { buffer.clear(); }
+  void EndOfEvent (G4HCofThisEvent*)                  override;
+private:
+  struct parts_of_event {
+    G4int                         run = -1;
+    std::vector<std::vector<hit>> hits; // by sub_events::part_of
+  };
+  // Shared with the copies in the worker threads
+  struct parts_of_events {
+    std::mutex                       mutex;
+    std::map<size_t, parts_of_event> pending; // by sub_events::event_of
+  };
+  std::vector<G4double> energies;
+  std::vector<G4double> pdes;
+  std::vector<size_t>   first_segment; // of each cell of a uniform grid over energies
+  G4double              cells_per_energy;
+  std::vector<hit>      buffer;
+  end_of_event_fn       eoev = [] (auto const&) {};
+  std::shared_ptr<parts_of_events> merging = std::make_shared<parts_of_events>();
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
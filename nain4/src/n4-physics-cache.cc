@@ -0,0 +1,136 @@
+#include <n4-physics-cache.hh>
+#include <n4-hash.hh>
+#include <n4-profile.hh>
+#include <n4-ui.hh>
+
+#include <G4Element.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4ProductionCuts.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4RunManager.hh>
+#include <G4VModularPhysicsList.hh>
+#include <G4VPhysicsConstructor.hh>
+#include <G4Version.hh>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <typeinfo>
+
+#include <unistd.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace fs = std::filesystem;
+
+namespace nain4 {
+namespace physics_cache {
+
+namespace {
+
+const std::string complete_marker = "n4-physics-cache-complete";
+
+// Doubles are hashed through their exact representation
+void describe(std::ostream& out, const G4PhysicsVector* v) {
+  if (! v) { return; }
+  out << std::hexfloat;
+  for (size_t i=0; i<v -> GetVectorLength(); i++) { out << v -> Energy(i) << ':' << (*v)[i] << ' '; }
+  out << std::defaultfloat;
+}
+
+std::string description() {
+  std::ostringstream out;
+  out << G4Version << '\n' << std::hexfloat;
+
+  auto physics = G4RunManager::GetRunManager() -> GetUserPhysicsList();
+  out << "physics " << typeid(*physics).name() << ' ' << physics -> GetDefaultCutValue() << '\n';
+  if (auto modular = dynamic_cast<const G4VModularPhysicsList*>(physics)) {
+    for (G4int i=0; auto constructor = modular -> GetPhysics(i); i++) {
+      out << "  " << constructor -> GetPhysicsName() << '\n';
+    }
+  }
+
+  for (auto region : *G4RegionStore::GetInstance()) {
+    out << "region " << region -> GetName();
+    if (auto cuts = region -> GetProductionCuts()) {
+      for (auto cut : cuts -> GetProductionCuts()) { out << ' ' << cut; }
+    }
+    out << '\n';
+  }
+
+  for (auto material : *G4Material::GetMaterialTable()) {
+    out << "material " << material -> GetName()
+        << ' ' << material -> GetDensity()
+        << ' ' << material -> GetState()
+        << ' ' << material -> GetTemperature()
+        << ' ' << material -> GetPressure() << '\n';
+    auto fractions = material -> GetFractionVector();
+    for (size_t i=0; i<material -> GetNumberOfElements(); i++) {
+      out << "  " << material -> GetElement(i) -> GetName() << ' ' << fractions[i] << '\n';
+    }
+    if (auto table = material -> GetMaterialPropertiesTable()) {
+      for (auto& name : table -> GetMaterialPropertyNames()) {
+        if (auto v = table -> GetProperty(name)) { out << "  " << name << ' '; describe(out, v); out << '\n'; }
+      }
+      for (auto& name : table -> GetMaterialConstPropertyNames()) {
+        if (table -> ConstPropertyExists(name)) { out << "  " << name << ' ' << table -> GetConstProperty(name) << '\n'; }
+      }
+    }
+  }
+  return out.str();
+}
+
+template<class F>
+double seconds(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+std::string key() { return hex(fnv1a(description())); }
+
+void build(const std::string& dir, ui& ui) {
+  profile::scope timer{"physics_cache", "build"};
+
+  auto entry  = fs::path{dir} / ("physics-" + key());
+  auto marker = entry / complete_marker;
+  auto build_physics = [&] { internal::exit_on_err(ui.beam_on(0)); };
+
+  double originally;
+  if (std::ifstream{marker} >> originally) {
+    internal::exit_on_err(ui.command("/run/particle/retrievePhysicsTable " + entry.string(), "physics-cache", ui::kind::command));
+    auto took = seconds(build_physics);
+    std::cout << "nain4::physics_cache: retrieved physics tables from " << entry.string()
+              << " in " << took << " s (building them took " << originally << " s)" << std::endl;
+    return;
+  }
+
+  auto took = seconds(build_physics);
+
+  // Store in a private directory and rename it into place: concurrent jobs
+  // may be trying to store the same entry.
+  auto tmp = fs::path{dir} / ("physics-tmp-" + std::to_string(getpid()));
+  fs::create_directories(tmp);
+  internal::exit_on_err(ui.command("/run/particle/storePhysicsTable " + tmp.string(), "physics-cache", ui::kind::command));
+  std::ofstream{tmp / complete_marker} << took << std::endl;
+
+  std::error_code already_there;
+  fs::rename(tmp, entry, already_there);
+  if (already_there) { fs::remove_all(tmp); }
+
+  std::cout << "nain4::physics_cache: built physics tables in " << took
+            << " s and stored them in " << entry.string() << std::endl;
+}
+
+} // namespace physics_cache
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+class ui;
+
+namespace physics_cache {
+
+// ---- Physics tables stored across processes, keyed by what they depend on --------------------------
+// The key is a hash of the physics constructors, production cuts, the
+// materials (composition, state and properties) and the Geant4 version, so
+// the tables of an entry are only reused by runs that would have built the
+// same ones. Enabled with `.physics_cache(DIR)` on the run manager, or with
+// --physics-cache DIR on the CLI.
+
+// Key of the current configuration; requires an initialized run manager
+std::string key();
+
+// Builds the physics tables (with /run/beamOn 0), retrieving them from the
+// entry in `dir` for the current key if there is one, and storing them there
+// otherwise. Reports how long it took, and how long building took originally.
+void build(const std::string& dir, ui& ui);
+
+} // namespace physics_cache
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -1,4 +1,5 @@
 #include <n4-place.hh>
+#include <n4-profile.hh>
 
 #include <G4LogicalVolume.hh>
 
@@ -25,6 +26,8 @@ G4PVPlacement* place::now() {
       the_name += suffix;
     }
   }
+  profile::scope timer{"place::now", the_name};
+
   // TODO: Think about these later
   bool WTF_is_pMany   = false;
 
@@ -0,0 +1,119 @@
+#include <n4-profile.hh>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <malloc.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace profile {
+
+namespace {
+
+bool enabled_ = false;
+
+std::mutex& registry_mutex() { static std::mutex m; return m; }
+std::map<std::pair<std::string, std::string>, entry>& registry() {
+  static std::map<std::pair<std::string, std::string>, entry> r;
+  return r;
+}
+
+long long heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  auto info = mallinfo2();
+  return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+  return 0;
+#endif
+}
+
+} // anonymous namespace
+
+void switch_on () { enabled_ = true ; }
+void switch_off() { enabled_ = false; }
+bool enabled   () { return enabled_; }
+
+void reset() {
+  std::lock_guard<std::mutex> lock{registry_mutex()};
+  registry().clear();
+}
+
+scope::scope(const char* phase, const std::string& name)
+  : active{enabled_}
+  , phase{phase}
+{
+  if (! active) { return; }
+  this -> name = name;
+  heap_start   = heap_in_use();
+  start        = std::chrono::steady_clock::now();
+}
+
+scope::~scope() {
+  if (! active) { return; }
+  auto stop  = std::chrono::steady_clock::now();
+  auto heap  = heap_in_use() - heap_start;
+  auto secs  = std::chrono::duration<double>(stop - start).count();
+
+  std::lock_guard<std::mutex> lock{registry_mutex()};
+  auto [it, _] = registry().try_emplace({phase, name}, entry{phase, name, 0, 0, 0});
+  auto& e = it -> second;
+  e.calls      += 1;
+  e.seconds    += secs;
+  e.heap_bytes += heap;
+}
+
+std::vector<entry> entries() {
+  std::vector<entry> result;
+  {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    result.reserve(registry().size());
+    for (auto& [_, e] : registry()) { result.push_back(e); }
+  }
+  std::sort(begin(result), end(result), [] (auto& a, auto& b) { return a.seconds > b.seconds; });
+  return result;
+}
+
+void report(std::ostream& out, size_t top) {
+  auto all = entries();
+
+  std::map<std::string, entry> phases;
+  for (auto& e : all) {
+    auto [it, _] = phases.try_emplace(e.phase, entry{e.phase, "", 0, 0, 0});
+    it -> second.calls      += e.calls;
+    it -> second.seconds    += e.seconds;
+    it -> second.heap_bytes += e.heap_bytes;
+  }
+  std::vector<entry> by_phase;
+  for (auto& [_, e] : phases) { by_phase.push_back(e); }
+  std::sort(begin(by_phase), end(by_phase), [] (auto& a, auto& b) { return a.seconds > b.seconds; });
+
+  auto line = [&] (const entry& e, const std::string& label) {
+    out << std::setw(12) << std::fixed << std::setprecision(3) << e.seconds * 1e3 << " ms"
+        << std::setw(10) << e.calls
+        << std::setw(14) << e.heap_bytes / 1024 << " KiB  "
+        << label << '\n';
+  };
+
+  out << "---- n4::profile: phases -----------------------------------------\n"
+      << std::setw(15) << "time" << std::setw(10) << "calls" << std::setw(18) << "heap" << "  phase\n";
+  for (auto& e : by_phase) { line(e, e.phase); }
+
+  out << "---- n4::profile: top " << std::min(top, all.size()) << " of " << all.size() << " -------------------------------------\n"
+      << std::setw(15) << "time" << std::setw(10) << "calls" << std::setw(18) << "heap" << "  phase / name\n";
+  for (size_t i=0; i<std::min(top, all.size()); i++) {
+    auto& e = all[i];
+    line(e, e.name.empty() ? e.phase : e.phase + " / " + e.name);
+  }
+  out << std::defaultfloat << std::flush;
+}
+
+} // namespace profile
+} // namespace nain4
+
+#pragma GCC diagnostic pop
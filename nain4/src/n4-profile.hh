@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace profile {
+
+// ---- Wall-time and heap profile of geometry construction and initialization ------------------------
+// Off by default, in which case instrumented code pays for a single branch.
+// Switch on before the run manager is initialized (or pass --profile on the
+// CLI) to find out which phases and which named volumes dominate startup.
+//
+//   n4::profile::switch_on();
+//   ... run_manager ... .run();        // report printed after initialization
+//   n4::profile::report(std::cout);    // or at any other time
+//
+// Times are inclusive: a boolean solid built inside shape::volume is counted
+// in both. Heap growth is the net change in bytes allocated through malloc
+// (glibc only), not the number of allocations.
+void switch_on ();
+void switch_off();
+bool enabled   ();
+void reset     ();
+
+struct entry {
+  std::string phase;
+  std::string name;
+  size_t      calls;
+  double      seconds;
+  long long   heap_bytes;
+};
+
+// Aggregated per (phase, name), sorted by decreasing time
+std::vector<entry> entries();
+// Phase totals followed by the `top` most expensive (phase, name) pairs
+void report(std::ostream&, size_t top = 30);
+
+// Times its own lifetime and charges it to (phase, name)
+struct scope {
+  scope(const char* phase, const std::string& name = "");
+  ~scope();
+  scope(const scope&) = delete;
+private:
+  bool                                  active;
+  const char*                           phase;
+  std::string                           name;
+  std::chrono::steady_clock::time_point start;
+  long long                             heap_start;
+};
+
+} // namespace profile
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
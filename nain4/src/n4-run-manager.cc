@@ -1,16 +1,20 @@
 #include <n4-run-manager.hh>
+#include <n4-overlaps.hh>
 
 #include "G4RunManager.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4PhysicalVolumeStore.hh"
+#include <G4StateManager.hh>
 #include <G4ThreeVector.hh>
 #include <G4UserRunAction.hh>
 #include <G4VUserDetectorConstruction.hh>
+#include <Randomize.hh>
 
 namespace nain4 {
 
 run_manager* run_manager::  rm_instance = nullptr;
 bool         run_manager::create_called = false;
+bool         run_manager::     hot_swap = false;
 
 
 void check_world_volume() {
@@ -49,6 +53,91 @@ void check_world_volume() {
   exit(EXIT_FAILURE);
 }
 
+void check_overlaps_and_exit(unsigned n_points, std::optional<long> seed) {
+  if (seed.has_value()) { G4Random::setTheSeed(seed.value()); }
+  auto overlaps = overlap_check().points(n_points).run();
+  auto n_found  = report_overlaps(std::cout, overlaps);
+  exit(n_found ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+void profile_voxelisation() {
+  auto geometry = G4GeometryManager::GetInstance();
+  {
+    profile::scope timer{"run_manager", "voxelisation"};
+    geometry -> CloseGeometry(true);
+  }
+  geometry -> OpenGeometry();
+}
+
+
+namespace {
+void exit_unless_between_runs(const G4String& method) {
+  auto state = G4StateManager::GetStateManager() -> GetCurrentState();
+  if (state != G4State_Idle && state != G4State_PreInit) {
+    std::cerr << method << " can only be called between runs." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+} // anonymous namespace
+
+
+void run_manager::modify_geometry(std::vector<G4VPhysicalVolume*> changed, side_effect_fn change) {
+  exit_unless_between_runs("run_manager::modify_geometry");
+
+  auto geometry = G4GeometryManager::GetInstance();
+
+  // Nothing to preserve: optimise everything once, after the change
+  if (! geometry -> IsGeometryClosed() || changed.empty()) {
+    geometry -> OpenGeometry();
+    change();
+    geometry -> CloseGeometry(true);
+    return;
+  }
+
+  // G4GeometryManager rebuilds the voxels of the *mother* of the volume it is
+  // given. Passing a daughter of a changed volume rebuilds the voxels of the
+  // changed volume itself, whose extent may have changed.
+  std::vector<G4VPhysicalVolume*> anchors;
+  for (auto volume : changed) {
+    anchors.push_back(volume);
+    auto logical = volume -> GetLogicalVolume();
+    if (logical -> GetNoDaughters() > 0) { anchors.push_back(logical -> GetDaughter(0)); }
+  }
+
+  geometry -> OpenGeometry(anchors.front());
+  change();
+  for (auto anchor : anchors) {
+    geometry ->  OpenGeometry(anchor);
+    geometry -> CloseGeometry(true, false, anchor);
+  }
+}
+
+
+void run_manager::reinitialize_geometry(n4::geometry::construct_fn build) {
+  exit_unless_between_runs("run_manager::reinitialize_geometry");
+  g4_manager -> ReinitializeGeometry(true);
+  g4_manager -> SetUserInitialization(new n4::geometry{build});
+  g4_manager -> Initialize();
+  check_world_volume();
+}
+
+
+void run_manager::reinitialize_actions(n4::actions_per_thread::build_fn build) {
+  exit_unless_between_runs("run_manager::reinitialize_actions");
+  g4_manager -> SetUserInitialization(new n4::actions_per_thread{build});
+}
+
+
+run_manager::G4RM run_manager::make_g4_manager(G4RunManagerType type, std::optional<unsigned> threads) {
+  auto multi = threads.has_value() && threads.value() > 0;
+  auto serial = type == G4RunManagerType::SerialOnly || type == G4RunManagerType::Serial;
+  if (multi && serial) { type = G4RunManagerType::MTOnly; }
+  auto g4_manager = G4RM{G4RunManagerFactory::CreateRunManager(type)};
+  if (multi) { g4_manager -> SetNumberOfThreads(static_cast<G4int>(threads.value())); }
+  return g4_manager;
+}
+
 
 void run_manager::exit_if_too_early(const G4String& method) {
   if (!run_manager::rm_instance) {
@@ -1,7 +1,11 @@
 // clang-format off
 #pragma once
 
+#include <n4-benchmark.hh>
 #include <n4-mandatory.hh>
+#include <n4-physics-cache.hh>
+#include <n4-profile.hh>
+#include <n4-telemetry.hh>
 #include <n4-ui.hh>
 
 #include <G4Run.hh>
@@ -17,6 +21,7 @@
 #include <G4VUserPrimaryGeneratorAction.hh>
 
 #include <cstdlib>
+#include <vector>
 
 
 class G4VUserDetectorConstruction;
@@ -44,6 +49,12 @@ namespace nain4 {
 // .physics<a_physics_list_type>(args...)       // implemented by NEXT_CONSTRUCT
 // .physics(zero_arg_fn_returning_physics_list) // implemented by NEXT_BUILD_FN
 
+// A function given to .actions(...) is called once per thread (see
+// n4::actions_per_thread): once in sequential mode, but once for the master
+// and once per worker with --threads. Anything it captures by reference is
+// therefore shared by all threads, and must be thread-safe or replaced by
+// per-thread state.
+
 // Geant4 requires that the physics list be set **BEFORE** a primary
 // generator class is **INSTANTIATED**. This requirement cannot be
 // fully enforced, but we try to make it less likely by suppressing
@@ -55,6 +66,10 @@ namespace nain4 {
 
 
 void check_world_volume();
+// Run n4::overlap_check with the given number of points and seed, report and exit
+[[noreturn]] void check_overlaps_and_exit(unsigned n_points, std::optional<long> seed);
+// Close and reopen the geometry, to measure the cost of building its voxels
+void profile_voxelisation();
 
 class run_manager {
   using G4RM = std::unique_ptr<G4RunManager>;
@@ -75,11 +90,47 @@ public:
 
   static bool available() { return rm_instance != nullptr; }
 
+  // Change existing volumes (solid dimensions, placements, ...) between runs,
+  // without reinitializing. Only the voxels of the mothers of the `changed`
+  // volumes, and of the changed volumes themselves, are rebuilt; if `changed`
+  // is empty, the whole geometry is reoptimised. This is much cheaper than
+  // replace_geometry, which rebuilds everything from scratch.
+  //
+  //   n4::run_manager::get().modify_geometry({straw}, [&] {
+  //     tubs -> SetOuterRadius(r);
+  //     straw -> SetTranslation({x, 0, 0});
+  //   });
+  void modify_geometry(std::vector<G4VPhysicalVolume*> changed, side_effect_fn change);
+
+  // Swap in a new geometry or new actions between runs, without going back
+  // through ready::run: unlike replace_geometry and replace_actions, the CLI is
+  // not applied again (no reseeding, overlap check, physics cache, benchmark,
+  // checkpoint or multiprocess run) and the run_manager instance is kept.
+  // Used by n4::scan.
+  void reinitialize_geometry(n4::geometry::construct_fn build);
+  void reinitialize_actions (n4::actions_per_thread::build_fn build);
+
+  // By default ready::run opens (un-optimises) the geometry when it is done.
+  // With hot-swap on, the geometry is left closed, so that the first call to
+  // modify_geometry does not have to optimise the whole geometry again.
+  void static hot_swap_switch_on () { hot_swap = true ; }
+  void static hot_swap_switch_off() { hot_swap = false; }
+
+  // Throughput, event latencies and peak memory of the last run that
+  // finished; all zero if there was none. See n4-telemetry.hh
+  nain4::telemetry::summary telemetry() const {
+    return nain4::telemetry::last_run().value_or(nain4::telemetry::summary{});
+  }
+
 private:
+  // Multi-threaded with the number of threads requested with --threads, `type` otherwise
+  static G4RM make_g4_manager(G4RunManagerType type, std::optional<unsigned> threads);
+
   G4RM g4_manager;
   n4::ui ui;
   static run_manager*   rm_instance;
   static bool         create_called;
+  static bool              hot_swap;
 
 // Each state needs temporarily owns the G4RunManager and hands over
 // ownership to the next state. The constructor is private to ensure
@@ -128,8 +179,15 @@ private:
     CORE(ready)
     run_manager* run(unsigned n) {return run(std::optional<unsigned>{n}); }
     run_manager* run(std::optional<unsigned> n_events = std::nullopt) {
-      g4_manager -> Initialize();
-      check_world_volume();
+      { profile::scope timer{"run_manager", "Initialize"        };
+        benchmark::scope bench{"initialize"}; g4_manager -> Initialize(); }
+      { profile::scope timer{"run_manager", "check_world_volume"}; check_world_volume();       }
+      if (profile::enabled()) {
+        profile_voxelisation();
+        profile::report(std::cout);
+      }
+      if (auto n_points = ui.check_overlaps()) { check_overlaps_and_exit(n_points.value(), ui.seed()); }
+      if (auto& dir     = ui.physics_cache ()) { physics_cache::build(dir.value(), ui); }
 
       // replace_geometry and replace_actions go back in the typestate
       // graph, therefore rm_instance might already exist. To prevent
@@ -138,7 +196,7 @@ private:
       run_manager::rm_instance = new run_manager{std::move(g4_manager), std::move(ui)};
 
       run_manager::rm_instance -> ui.run(n_events);
-      G4GeometryManager::GetInstance() -> OpenGeometry();
+      if (! run_manager::hot_swap) { G4GeometryManager::GetInstance() -> OpenGeometry(); }
 
       return run_manager::rm_instance;
     }
@@ -147,6 +205,8 @@ private:
     ready apply_command   (const G4String& command_) { exit_on_err(ui.command  (command_, "late", command )); return std::move(*this); }
     ready apply_late_macro(const G4String& filename) { exit_on_err(ui.run_macro(filename, "late"          )); return std::move(*this); }
     ready apply_cli_late  (                        ) { exit_on_err(ui.run_late (                          )); return std::move(*this); }
+    // Store physics tables in (and later retrieve them from) DIR: see n4-physics-cache.hh
+    ready physics_cache   (const G4String& dir     ) { ui.physics_cache(dir); return std::move(*this); }
   };
 
   struct set_actions {
@@ -157,9 +217,10 @@ private:
 
     NEXT_STATE_BASIC(ready, actions, G4VUserActionInitialization)
     NEXT_CONSTRUCT  (ready, actions)
-    NEXT_BUILD_FN   (ready, actions, fn_type, new n4::actions{new n4::generator{build}})
-    NEXT_BUILD_FN   (ready, actions, gn_type, new n4::actions{build()})
-    NEXT_BUILD_FN   (ready, actions, ac_type, build())
+    // Functions are called once per thread: see n4::actions_per_thread
+    NEXT_BUILD_FN   (ready, actions, fn_type, new n4::actions_per_thread{[build] { return new n4::actions{new n4::generator{build}}; }})
+    NEXT_BUILD_FN   (ready, actions, gn_type, new n4::actions_per_thread{[build] { return new n4::actions{build()}; }})
+    NEXT_BUILD_FN   (ready, actions, ac_type, new n4::actions_per_thread{build})
   };
 
   struct set_geometry {
@@ -187,20 +248,24 @@ private:
     NEXT_BUILD_FN   (set_geometry, physics, fn_type, build())
   };
 
+  // The G4RunManager is only created once the CLI has been parsed, as
+  // --threads may ask for a multi-threaded one
   struct initialize_ui {
     friend run_manager;
 
   private:
-    G4RM g4_manager;
-    initialize_ui(G4RM g4_manager) : g4_manager{std::move(g4_manager)} { }
+    G4RunManagerType type;
+    initialize_ui(G4RunManagerType type) : type{type} { }
 
   public:
     set_physics ui(const std::string& program_name, int argc, char** argv, bool warn_empty_run=true) {
       auto ui = n4::ui(program_name, argc, argv, warn_empty_run);
+      auto g4_manager = make_g4_manager(type, ui.threads());
       return {std::move(g4_manager), std::move(ui)};
     }
     set_physics fake_ui() {
       auto ui = n4::ui::fake_ui();
+      auto g4_manager = make_g4_manager(type, ui.threads());
       return {std::move(g4_manager), std::move(ui)};
     }
   };
@@ -216,9 +281,8 @@ public:
     }
 
     run_manager::create_called = true;
-
-    auto g4_manager = std::unique_ptr<G4RunManager>{G4RunManagerFactory::CreateRunManager(type)};
-    return initialize_ui{std::move(g4_manager)};
+    benchmark::started();
+    return initialize_ui{type};
   }
 
   static void exit_if_too_early(const G4String& method);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <n4-mandatory.hh>
+#include <n4-run-manager.hh>
+
+#include <G4VPhysicalVolume.hh>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- In-process parameter scans -------------------------------------------------------------------
+// Runs the same application over a list of configurations, within a single
+// process, so that physics tables are built only once. For each configuration
+// the geometry and/or actions are replaced (run_manager::reinitialize_geometry
+// and reinitialize_actions, which do not reapply the CLI), the given commands
+// are applied, `events` events are run with a plain /run/beamOn and `result`
+// is called to collect whatever the actions accumulated.
+//
+// The run manager must already have been configured and run, e.g. with .run(0).
+//
+//   auto radii   = std::vector<double>{1*mm, 2*mm, 3*mm};
+//   auto yields  = n4::scan<double, double>()
+//     .geometry([] (double r) { return detector(r); })
+//     .actions ([&](double  ) { counts = 0; return make_actions(counts); })
+//     .commands([] (double  ) { return std::vector<std::string>{"/gun/energy 1 MeV"}; })
+//     .events(1000)
+//     .result  ([&](double  ) { return counts / 1000.; })
+//     .run(radii);
+template<class CONFIG, class RESULT>
+class scan {
+public:
+  using geometry_fn = std::function<G4VPhysicalVolume*       (const CONFIG&)>;
+  using actions_fn  = std::function<n4::actions*             (const CONFIG&)>;
+  using commands_fn = std::function<std::vector<std::string> (const CONFIG&)>;
+  using result_fn   = std::function<RESULT                   (const CONFIG&)>;
+
+  scan& geometry(geometry_fn f) { geometry_ = f; return *this; }
+  scan& actions (actions_fn  f) { actions_  = f; return *this; }
+  scan& commands(commands_fn f) { commands_ = f; return *this; }
+  scan& result  (result_fn   f) { result_   = f; return *this; }
+  scan& events  (unsigned    n) { events_   = n; return *this; }
+
+  // One result per configuration, in the same order
+  std::vector<RESULT> run(const std::vector<CONFIG>& configs) const {
+    run_manager::exit_if_too_early("n4::scan::run");
+    if (! result_) {
+      std::cerr << "n4::scan::run called without specifying .result(...)" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    std::vector<RESULT> results;
+    results.reserve(configs.size());
+    for (const auto& config : configs) {
+      // The run manager keeps these functions: they must not refer to the scan or the loop
+      if (geometry_) {
+        run_manager::get().reinitialize_geometry([geometry = geometry_, config] { return geometry(config); });
+      }
+      if (actions_) {
+        run_manager::get().reinitialize_actions ([actions  = actions_ , config] { return actions (config); });
+      }
+
+      auto& cli = run_manager::get_ui();
+      if (commands_) {
+        for (const auto& command : commands_(config)) {
+          internal::exit_on_err(cli.command(command, "scan", ui::kind::command));
+        }
+      }
+      if (events_ > 0) { internal::exit_on_err(cli.beam_on(events_)); }
+      results.push_back(result_(config));
+    }
+    return results;
+  }
+
+private:
+  geometry_fn geometry_;
+  actions_fn  actions_;
+  commands_fn commands_;
+  result_fn   result_;
+  unsigned    events_ = 0;
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
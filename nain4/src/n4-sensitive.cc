@@ -8,4 +8,8 @@ sensitive_detector::sensitive_detector(G4String name, process_hits_fn process_hi
   fully_activate_sensitive_detector(this);
 }
 
+G4VSensitiveDetector* sensitive_detector::Clone() const {
+  return (new sensitive_detector{GetName(), process_hits}) -> initialize(init) -> end_of_event(eoev);
+}
+
 } // namespace nain4
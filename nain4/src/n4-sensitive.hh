@@ -16,6 +16,8 @@ public:
   sensitive_detector* end_of_event(end_of_event_fn f) { eoev = f; return this; }
 
   sensitive_detector(G4String name, process_hits_fn process_hits);
+  // For the worker threads: shares the functions, which must be thread-safe
+  G4VSensitiveDetector* Clone() const override;
   bool ProcessHits(G4Step* step, G4TouchableHistory*) override { return process_hits(step); };
   void Initialize (G4HCofThisEvent* hc)               override {        init        (hc  ); };
   void EndOfEvent (G4HCofThisEvent* hc)               override {        eoev        (hc  ); };
@@ -1,12 +1,15 @@
 #include <n4-shape.hh>
 #include <n4-boolean-shape.hh>
+#include <n4-profile.hh>
 #include <n4-volume.hh>
 
 #include <G4LogicalVolume.hh>
+#include <G4TriangularFacet.hh>
 #include <G4String.hh>
 #include <G4VGraphicsScene.hh>
 #include <G4VPVParameterisation.hh>
 
+#include <algorithm>
 #include <cstdlib>
 
 #pragma GCC diagnostic push
@@ -68,6 +71,8 @@ boolean_shape shape::join_ (G4VSolid* solid) { return add_      (solid); }
 boolean_shape shape::sub_  (G4VSolid* solid) { return subtract_ (solid); }
 boolean_shape shape::inter_(G4VSolid* solid) { return intersect_(solid); }
 
+boolean_shape shape::subtract_all(multi_union const& parts) { return subtract_(parts.solid()); }
+
 template<class... Args>
 void check_mandatory_args(G4String type, G4String name, Args&&... args) {
   for(const auto arg : {args...}) {
@@ -119,7 +124,42 @@ G4Trd* trd::solid() const {
   return new G4Trd(name_, half_x1_.value(), half_x2_.value(), half_y1_.value(), half_y2_.value(), half_z_.value());
 }
 
+G4TessellatedSolid* tessellated::solid() const {
+  profile::scope timer{"tessellated::solid", name_};
+  if (file_.has_value() == mesh_.has_value()) {
+    throw "You must provide exactly one of .file(...) or .mesh(...) for the n4::tessellated " + name_ + ".";
+  }
+  auto from_file = file_.has_value() ? std::optional{read_mesh(file_.value(), unit_)} : std::nullopt;
+  auto& [vertices, triangles] = from_file.has_value() ? from_file.value() : mesh_.value();
+
+  auto solid = new G4TessellatedSolid{name_};
+  if (max_voxels_.has_value()) { solid -> SetMaxVoxels(max_voxels_.value()); }
+  for (auto& [a, b, c] : triangles) {
+    solid -> AddFacet(new G4TriangularFacet{vertices[a], vertices[b], vertices[c], ABSOLUTE});
+  }
+  solid -> SetSolidClosed(true);
+  return solid;
+}
+
+G4ExtrudedSolid* extruded::solid() const {
+  if (polygon_.size() < 3) {
+    throw "The polygon of the n4::extruded " + name_ + " needs at least 3 vertices.";
+  }
+  if (sections_.empty()) {
+    check_mandatory_args("extruded", name_, half_z_);
+    auto h = half_z_.value();
+    return new G4ExtrudedSolid{name_, polygon_, h, {0, 0}, 1, {0, 0}, 1};
+  }
+  if (half_z_.has_value() || sections_.size() < 2) {
+    throw "Provide either .z(...) or at least two .section(...)s, not both, for the n4::extruded " + name_ + ".";
+  }
+  auto sections = sections_;
+  std::sort(begin(sections), end(sections), [] (auto& a, auto& b) { return a.fZ < b.fZ; });
+  return new G4ExtrudedSolid{name_, polygon_, sections};
+}
+
 G4LogicalVolume* shape::volume(G4Material* material) const {
+  profile::scope timer{"shape::volume", name_};
   auto vol = n4::volume(solid(), material);
   if (sd.has_value()) { vol -> SetSensitiveDetector(sd.value()); }
   if (va.has_value()) { vol -> SetVisAttributes    (va.value()); }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <n4-mesh.hh>
 #include <n4-place.hh>
 #include <n4-sensitive.hh>
 
@@ -8,10 +9,13 @@
 
 #include <G4Box.hh>
 #include <G4Cons.hh>
+#include <G4ExtrudedSolid.hh>
 #include <G4Orb.hh>
 #include <G4Sphere.hh>
+#include <G4TessellatedSolid.hh>
 #include <G4Trd.hh>
 #include <G4Tubs.hh>
+#include <G4TwoVector.hh>
 
 #include <G4LogicalVolume.hh>
 #include <G4VisAttributes.hh>
@@ -21,6 +25,8 @@
 class G4VSensitiveDetector;
 
 #include <optional>
+#include <string>
+#include <vector>
 
 #define G4D G4double
 #define OPT_DOUBLE std::optional<G4double>
@@ -32,6 +38,7 @@ namespace nain4 {
 #pragma GCC diagnostic ignored "-Wshadow"
 
 struct boolean_shape;
+struct multi_union;
 
 // ---- Base class for interfaces to G4VSolids --------------------------------------------------------
 struct shape {
@@ -68,6 +75,10 @@ public:
   template<class SUBTYPE> boolean_shape sub      (SUBTYPE x);
   template<class SUBTYPE> boolean_shape inter    (SUBTYPE x);
 
+  // Subtract many solids at once: a single G4SubtractionSolid whose second
+  // operand is the (voxelized) union of all of them.
+  boolean_shape subtract_all(multi_union const& parts);
+
 
 protected:
   shape(G4String name) : name_{name} {}
@@ -203,6 +214,39 @@ public:
   trd& half_xy2(G4D l) { half_x2(l); half_y2(l); return *this;}
 };
 
+// Closed surface made of triangles, typically exported from CAD. Provide either
+// a mesh file (.stl, ASCII or binary, or .obj) whose coordinates are in units
+// of .unit(...) (mm by default), or an n4::mesh in Geant4 units.
+// The solid is closed, which builds Geant4's voxel acceleration structure;
+// .max_voxels(...) trades memory for navigation speed on very large meshes.
+struct tessellated : shape {
+  COMMON(tessellated, G4TessellatedSolid)
+public:
+  tessellated& file      (const std::string& path) { file_       = path        ; return *this; }
+  tessellated& mesh      (nain4::mesh        m   ) { mesh_       = std::move(m); return *this; }
+  tessellated& unit      (G4D                u   ) { unit_       = u           ; return *this; }
+  tessellated& max_voxels(G4int              n   ) { max_voxels_ = n           ; return *this; }
+private:
+  std::optional<std::string> file_;
+  std::optional<nain4::mesh> mesh_;
+  G4D                        unit_ = CLHEP::mm;
+  std::optional<G4int>       max_voxels_;
+};
+
+// Polygon extruded along z. Either give its full (.z) or half (.half_z)
+// length, or describe each z-section (.section) with its offset and scale.
+struct extruded : shape {
+  COMMON(extruded, G4ExtrudedSolid)
+  HAS_Z (extruded,)
+public:
+  extruded& polygon(std::vector<G4TwoVector> p) { polygon_ = std::move(p); return *this; }
+  extruded& vertex (G4D x, G4D y)               { polygon_.emplace_back(x, y); return *this; }
+  extruded& section(G4D z, G4TwoVector offset = {}, G4D scale = 1) { sections_.emplace_back(z, offset, scale); return *this; }
+private:
+  std::vector<G4TwoVector>               polygon_;
+  std::vector<G4ExtrudedSolid::ZSection> sections_;
+};
+
 
 // ---- Ensure that local macros don't leak out -------------------------------------------------------
 #undef G4D
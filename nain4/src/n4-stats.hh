@@ -6,6 +6,8 @@
 #include <boost/math/statistics/bivariate_statistics.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <numeric>
 #include <optional>
 #include <type_traits>
@@ -72,6 +74,54 @@ auto min_max(const CONTAINER& data)
   });
   return {{min, max}};
 }
+
+// ---- Streaming statistics -----------------------------------------------------
+// Mean and variance of a stream of values, in a single pass and constant
+// memory (Welford's algorithm). Accumulators filled separately, for instance
+// in different threads, can be merged.
+struct running {
+  void add(double x) {
+    n++;
+    auto delta = x - mean_;
+    mean_ += delta / n;
+    m2    += delta * (x - mean_);
+  }
+
+  void merge(running const& other) {
+    if (! other.n) { return; }
+    auto total = n + other.n;
+    auto delta = other.mean_ - mean_;
+    m2    += other.m2 + delta * delta * n * other.n / total;
+    mean_ += delta * other.n / total;
+    n      = total;
+  }
+
+  size_t count() const { return n; }
+
+  std::optional<double> mean               () const { if (n < 1) { return {}; } return mean_; }
+  std::optional<double> variance_population() const { if (n < 1) { return {}; } return m2 /  n     ; }
+  std::optional<double> variance_sample    () const { if (n < 2) { return {}; } return m2 / (n - 1); }
+  std::optional<double> std_dev_population () const { if (n < 1) { return {}; } return std::sqrt(m2 /  n     ); }
+  std::optional<double> std_dev_sample     () const { if (n < 2) { return {}; } return std::sqrt(m2 / (n - 1)); }
+
+  // Standard error of the mean
+  std::optional<double> std_error() const {
+    if (n < 2) { return {}; }
+    return std::sqrt(m2 / (n - 1) / n);
+  }
+
+  // Standard error of the mean, relative to the mean
+  std::optional<double> relative_error() const {
+    if (n < 2 || mean_ == 0) { return {}; }
+    return std_error().value() / std::abs(mean_);
+  }
+
+private:
+  size_t n     = 0;
+  double mean_ = 0;
+  double m2    = 0; // sum of squared differences from the mean
+};
+
 }
 } // namespace nain4
 
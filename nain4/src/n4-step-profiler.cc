@@ -0,0 +1,179 @@
+#include <n4-step-profiler.hh>
+
+#include <G4LogicalVolume.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4StateManager.hh>
+#include <G4Step.hh>
+#include <G4Threading.hh>
+#include <G4VProcess.hh>
+#include <G4ios.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+namespace {
+
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+double seconds_now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline size_t hash(void const* a, void const* b, void const* c) {
+  auto h = reinterpret_cast<uintptr_t>(a) * 0x9E3779B97F4A7C15ull;
+  h ^= reinterpret_cast<uintptr_t>(b) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  h ^= reinterpret_cast<uintptr_t>(c) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  return h ^ (h >> 29);
+}
+
+} // anonymous namespace
+
+step_profiler::step_profiler(G4UserSteppingAction* inner)
+: inner{inner}
+, state{G4StateManager::GetStateManager() -> GetCurrentState()}
+{}
+
+step_profiler::~step_profiler() { delete inner; }
+
+step_profiler::slot& step_profiler::find(G4LogicalVolume const* volume, G4ParticleDefinition const* particle, G4VProcess const* process) {
+  auto mask = table.size() - 1;
+  for (auto i = hash(volume, particle, process) & mask; ; i = (i + 1) & mask) {
+    auto& s = table[i];
+    if (s.volume == volume && s.particle == particle && s.process == process && s.steps) { return s; }
+    if (! s.steps) {
+      if (2 * (used + 1) > table.size()) { grow(); return find(volume, particle, process); }
+      used++;
+      s = {volume, particle, process, 0, 0};
+      return s;
+    }
+  }
+}
+
+void step_profiler::grow() {
+  auto old = std::move(table);
+  table = std::vector<slot>(2 * old.size());
+  used  = 0;
+  for (auto& s : old) {
+    if (s.steps) { find(s.volume, s.particle, s.process) = s; }
+  }
+}
+
+void step_profiler::UserSteppingAction(G4Step const* step) {
+  auto now   = ticks();
+  auto track = step -> GetTrack();
+  if (track -> GetParentID() != 0 || track -> GetCurrentStepNumber() != 1) {
+    auto  volume  = step  -> GetPreStepPoint()  -> GetPhysicalVolume() -> GetLogicalVolume();
+    auto  process = step  -> GetPostStepPoint() -> GetProcessDefinedStep();
+    auto& s       = find(volume, track -> GetDefinition(), process);
+    s.steps++;
+    s.ticks += now - last;
+  }
+  if (inner) { inner -> UserSteppingAction(step); }
+  last = ticks();
+}
+
+G4bool step_profiler::Notify(G4ApplicationState requested) {
+  if (state == G4State_Idle && requested == G4State_GeomClosed) { // start of run
+    reset();
+    run_ticks = ticks();
+    run_start = seconds_now();
+  }
+  if (state == G4State_GeomClosed && requested == G4State_Idle) { // end of run
+    auto elapsed_ticks = ticks() - run_ticks;
+    seconds_per_tick   = elapsed_ticks ? (seconds_now() - run_start) / elapsed_ticks : 0;
+    report(G4cout);
+    if (! dump_path.empty()) {
+      auto path = G4Threading::IsWorkerThread()
+        ? dump_path + "-" + std::to_string(G4Threading::G4GetThreadId())
+        : dump_path;
+      write_dump(path);
+    }
+  }
+  state = requested;
+  return true;
+}
+
+void step_profiler::reset() {
+  std::fill(begin(table), end(table), slot{});
+  used = 0;
+}
+
+std::vector<step_profiler::bucket> step_profiler::buckets() const {
+  std::vector<bucket> result;
+  result.reserve(used);
+  for (auto& s : table) {
+    if (! s.steps) { continue; }
+    result.push_back({ s.volume   ? s.volume   -> GetName()         : "none"
+                     , s.particle ? s.particle -> GetParticleName() : "none"
+                     , s.process  ? s.process  -> GetProcessName()  : "none"
+                     , s.steps
+                     , s.ticks * seconds_per_tick });
+  }
+  std::sort(begin(result), end(result), [] (auto& a, auto& b) { return a.seconds > b.seconds; });
+  return result;
+}
+
+void step_profiler::report(std::ostream& out) const {
+  auto all   = buckets();
+  auto total = 0.0;
+  std::map<std::string, double> by_volume, by_particle, by_process;
+  for (auto& b : all) {
+    total                  += b.seconds;
+    by_volume  [b.volume  ] += b.seconds;
+    by_particle[b.particle] += b.seconds;
+    by_process [b.process ] += b.seconds;
+  }
+
+  auto line = [&] (double seconds, std::string const& label) {
+    out << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1e3 << " ms"
+        << std::setw(7) << std::setprecision(1) << (total ? 100 * seconds / total : 0) << " %  "
+        << label << '\n';
+  };
+  auto section = [&] (std::string const& title, std::map<std::string, double> const& totals) {
+    std::vector<std::pair<std::string, double>> sorted{begin(totals), end(totals)};
+    std::sort(begin(sorted), end(sorted), [] (auto& a, auto& b) { return a.second > b.second; });
+    out << "---- n4::step_profiler: by " << title << " ----\n";
+    for (auto& [name, seconds] : sorted) { line(seconds, name); }
+  };
+
+  section("volume"  , by_volume  );
+  section("particle", by_particle);
+  section("process" , by_process );
+  out << "---- n4::step_profiler: top " << std::min(n_top, all.size()) << " of " << all.size()
+      << " (volume / particle / process) ----\n";
+  for (size_t i=0; i<std::min(n_top, all.size()); i++) {
+    auto& b = all[i];
+    line(b.seconds, b.volume + " / " + b.particle + " / " + b.process + "  (" + std::to_string(b.steps) + " steps)");
+  }
+  out << std::defaultfloat << std::flush;
+}
+
+void step_profiler::write_dump(std::string const& path) const {
+  std::ofstream out{path};
+  out << "volume,particle,process,steps,seconds\n";
+  for (auto& b : buckets()) {
+    out << b.volume << ',' << b.particle << ',' << b.process << ',' << b.steps << ',' << b.seconds << '\n';
+  }
+}
+
+} // namespace nain4
+
+#pragma GCC diagnostic pop
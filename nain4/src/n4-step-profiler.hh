@@ -0,0 +1,91 @@
+#pragma once
+
+#include <G4ApplicationState.hh>
+#include <G4UserSteppingAction.hh>
+#include <G4VStateDependent.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+
+// ---- Step time per (logical volume, particle, process) -----------------------------------------------
+// A stepping action which charges the time elapsed since the previous step to
+// the step's pre-step logical volume, particle and post-step process, using
+// the CPU timestamp counter where available. Wrap your own stepping action (if
+// any) in it: the time spent in that action is excluded, and the profiler
+// takes ownership of it.
+//
+//   actions -> set((new n4::step_profiler{my_stepping_action}) -> dump("steps.csv"));
+//
+// At the end of each run the buckets are reported, sorted by time, to G4cout
+// and, if requested, written as CSV (volume,particle,process,steps,seconds).
+// Each thread profiles its own steps: in multi-threaded runs every worker
+// reports separately, and its thread ID is appended to the dump file name.
+//
+// The gap before the first step of each primary track (which includes event
+// generation and user event actions) is excluded; the gap before the first
+// step of any other track is charged to that step.
+class step_profiler : public G4UserSteppingAction, public G4VStateDependent {
+public:
+  struct bucket {
+    std::string volume;
+    std::string particle;
+    std::string process;
+    size_t      steps;
+    double      seconds;
+  };
+
+  step_profiler(G4UserSteppingAction* inner = nullptr);
+  ~step_profiler() override;
+
+  step_profiler* dump(std::string const& path) { dump_path = path; return this; }
+  step_profiler* top (size_t n               ) { n_top     = n   ; return this; }
+
+  void   UserSteppingAction(G4Step const*)      override;
+  G4bool Notify            (G4ApplicationState) override;
+
+  // Sorted by decreasing time
+  std::vector<bucket> buckets() const;
+  void report    (std::ostream&)      const;
+  void write_dump(std::string const&) const;
+  void reset();
+
+private:
+  struct slot {
+    G4LogicalVolume      const* volume;
+    G4ParticleDefinition const* particle;
+    G4VProcess           const* process;
+    size_t                      steps;
+    uint64_t                    ticks;
+  };
+  slot& find(G4LogicalVolume const*, G4ParticleDefinition const*, G4VProcess const*);
+  void  grow();
+
+  G4UserSteppingAction* inner;
+  std::string           dump_path;
+  size_t                n_top      = 30;
+  std::vector<slot>     table      = std::vector<slot>(1024); // open addressing, power of 2 size
+  size_t                used       = 0;
+  uint64_t              last       = 0;
+  uint64_t              run_ticks  = 0;
+  double                run_start  = 0;
+  double                seconds_per_tick = 0;
+  G4ApplicationState    state;
+};
+
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
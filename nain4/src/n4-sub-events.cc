@@ -0,0 +1,188 @@
+#include <n4-sub-events.hh>
+
+#include <G4OpticalPhoton.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4MTRunManager.hh>
+#include <G4RunManager.hh>
+#include <G4TaskRunManager.hh>
+
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace sub_events {
+
+namespace {
+
+struct offloaded {
+  G4ParticleDefinition const* particle;
+  G4ThreeVector               position;
+  G4ThreeVector               momentum;
+  G4ThreeVector               polarization;
+  G4double                    time;
+  G4double                    weight;
+};
+
+// A requested event whose parts have not all finished
+struct in_progress {
+  std::vector<offloaded> tracks;
+  bool                   complete  = false; // no more tracks will be offloaded
+  unsigned               remaining = 0;     // parts still to finish
+  std::vector<std::function<void()>> when_done;
+};
+
+bool      enabled_ = false;
+unsigned  k_       = 1;
+select_fn select_;
+done_fn   done_;
+
+std::mutex                    mutex;
+std::condition_variable       tracks_complete;
+std::map<size_t, in_progress> unfinished;
+std::atomic<size_t>           generated{0}; // sub-events, in this run
+
+[[noreturn]] void fail(std::string const& message) {
+  std::cerr << "n4::sub_events: " << message << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+// The tracks offloaded by the event this thread is simulating, if it is not a sub-event
+thread_local std::vector<offloaded>* filling = nullptr;
+
+// Needs the mutex
+in_progress& find(size_t event) {
+  auto [found, created] = unfinished.try_emplace(event);
+  if (created) { found -> second.remaining = parts(); }
+  return found -> second;
+}
+
+} // anonymous namespace
+
+bool optical_photons(G4Track const* track) { return track -> GetDefinition() == G4OpticalPhoton::Definition(); }
+
+void switch_on(unsigned sub_events, select_fn select) {
+  if (sub_events == 0) { fail("the number of sub-events must be positive"); }
+  enabled_ = true;
+  k_       = sub_events;
+  select_  = select;
+}
+
+void switch_off() { enabled_ = false; done_ = {}; }
+bool enabled   () { return enabled_; }
+
+size_t parts       ()                     { return k_ + 1; }
+size_t event_of    (G4Event const* event) { return static_cast<size_t>(event -> GetEventID()) / parts(); }
+size_t part_of     (G4Event const* event) { return static_cast<size_t>(event -> GetEventID()) % parts(); }
+bool   is_sub_event(G4Event const* event) { return part_of(event) != 0; }
+
+void on_done(done_fn done) { done_ = done; }
+
+void when_done(G4Event const* part, std::function<void()> fn) {
+  std::lock_guard<std::mutex> lock{mutex};
+  find(event_of(part)).when_done.push_back(fn);
+}
+
+bool generate(G4Event* event) {
+  std::unique_lock<std::mutex> lock{mutex};
+  auto& parent = find(event_of(event));
+
+  if (! is_sub_event(event)) {
+    // std::map never moves its elements, so the pointer stays valid
+    filling = &parent.tracks;
+    return false;
+  }
+
+  tracks_complete.wait(lock, [&parent] { return parent.complete; });
+  lock.unlock();
+  generated++;
+
+  // The tracks no longer change, and are kept until this sub-event finishes
+  auto n     = parent.tracks.size();
+  auto sub   = part_of(event) - 1;
+  auto first = n *  sub      / k_;
+  auto last  = n * (sub + 1) / k_;
+  for (auto i=first; i<last; i++) {
+    auto& t       = parent.tracks[i];
+    auto particle = new G4PrimaryParticle{t.particle, t.momentum.x(), t.momentum.y(), t.momentum.z()};
+    particle -> SetPolarization(t.polarization);
+    particle -> SetWeight      (t.weight);
+    auto vertex = new G4PrimaryVertex{t.position, t.time};
+    vertex -> SetPrimary(particle);
+    event  -> AddPrimaryVertex(vertex);
+  }
+  return true;
+}
+
+bool offload(G4Track const* track) {
+  if (! filling || track -> GetParentID() == 0 || ! select_(track)) { return false; }
+  filling -> push_back({ track -> GetDefinition()
+                       , track -> GetPosition()
+                       , track -> GetMomentum()
+                       , track -> GetPolarization()
+                       , track -> GetGlobalTime()
+                       , track -> GetWeight()
+                       });
+  return true;
+}
+
+void event_finished(G4Event const* event) {
+  auto parent_id = event_of(event);
+  std::vector<std::function<void()>> when_done;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& parent = find(parent_id);
+    if (! is_sub_event(event)) {
+      filling         = nullptr;
+      parent.complete = true;
+      tracks_complete.notify_all();
+    }
+    if (--parent.remaining > 0) { return; }
+    when_done = std::move(parent.when_done);
+    unfinished.erase(parent_id);
+  }
+  for (auto& fn : when_done) { fn(); }
+  if (done_) { done_(parent_id); }
+}
+
+void run(G4int events, std::function<void(G4int)> beam_on) {
+  // Sub-events wait for their event to be simulated. The task run manager may
+  // hand all its threads to sub-events whose events are still queued.
+  if (dynamic_cast<G4TaskRunManager*>(G4RunManager::GetRunManager())) {
+    fail("sub-events need a sequential or G4MTRunManager (MTOnly) run manager, not a task-based one");
+  }
+  if (events > INT_MAX / static_cast<G4int>(parts())) {
+    fail(std::to_string(events) + " events with " + std::to_string(k_) + " sub-events each do not fit in one run");
+  }
+  {
+    // Leftovers of an aborted run
+    std::lock_guard<std::mutex> lock{mutex};
+    unfinished.clear();
+  }
+  generated = 0;
+  // G4MTRunManager hands out blocks of consecutive event IDs, which would
+  // give an event and its sub-events to the same worker, one after another
+  auto mt     = dynamic_cast<G4MTRunManager*>(G4RunManager::GetRunManager());
+  auto modulo = mt ? mt -> GetEventModulo() : 0;
+  if (mt) { mt -> SetEventModulo(1); }
+  beam_on(events * static_cast<G4int>(parts()));
+  if (mt) { mt -> SetEventModulo(modulo); }
+  if (events > 0 && generated == 0) {
+    fail("the sub-events were not generated by an n4::generator, so each of them simulated a whole event");
+  }
+}
+
+} // namespace sub_events
+} // namespace nain4
+
+#pragma GCC diagnostic pop
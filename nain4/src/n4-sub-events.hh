@@ -0,0 +1,79 @@
+#pragma once
+
+#include <G4Event.hh>
+#include <G4Track.hh>
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <functional>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace sub_events {
+
+// ---- Share the secondaries of huge events among worker threads ---------------------------------------
+// Off by default. Switch on (or pass --sub-events K on the CLI) to cut the
+// latency of events dominated by many cheap secondaries, such as optical
+// photons. Each event requested from ui::run becomes K+1 Geant4 events:
+//
+// + the event itself, generated by n4::generator as usual, in which the
+//   selected secondaries are taken off the stack as they are created
+//   (after the stacking action has classified them, so n4::optical_stacking
+//   sampling and dropping still apply),
+//
+// + K sub-events, whose primaries are those secondaries, split evenly. They
+//   wait for the secondaries of their event, and are then tracked in parallel
+//   by whichever worker threads are free.
+//
+// n4::photodetector merges the hits of all the parts, and hands them to its
+// end_of_event function once per requested event. Other sensitive detectors
+// see each part as an event of its own, and can merge their hits with
+// `when_done`. The secondaries lose their track and parent IDs.
+//
+// Needs n4::actions with an n4::generator, and n4 event and stacking actions
+// if any, and a sequential or MTOnly run manager: the task-based one could
+// leave every thread waiting on a sub-event. With MTOnly, events are handed
+// to the workers one at a time (event modulo 1) during the run.
+//
+// Counts of events elsewhere in nain4, such as multiprocess::first_event and
+// checkpoint::events_done, are in requested events: add them to `event_of`,
+// not to the Geant4 event ID.
+using select_fn = std::function<bool (G4Track const*)>;
+bool optical_photons(G4Track const*);
+
+void switch_on (unsigned sub_events, select_fn select = optical_photons);
+void switch_off();
+bool enabled   ();
+
+// Parts per requested event (K+1), the requested event of which `event` is a
+// part, which part it is (0 for the event itself), and whether it is a sub-event
+size_t parts       ();
+size_t event_of    (G4Event const*);
+size_t part_of     (G4Event const*);
+bool   is_sub_event(G4Event const*);
+
+// Called with the requested event once it and all its sub-events have
+// finished, in the thread which finished the last of them
+using done_fn = std::function<void (size_t event)>;
+void on_done(done_fn);
+
+// Calls `fn` once the requested event of which `part` is a part has finished,
+// in the thread which finished the last of its parts, just before `on_done`.
+// Call it before `part` itself finishes, e.g. from the EndOfEvent of a
+// sensitive detector.
+void when_done(G4Event const* part, std::function<void()> fn);
+
+// Hooks called by n4::generator, n4::stacking_action, n4::event_action and ui::run
+bool generate      (G4Event*);     // true if it generated a sub-event
+bool offload       (G4Track const*); // true if the track was taken off the stack
+void event_finished(G4Event const*);
+void run(G4int events, std::function<void(G4int)> beam_on);
+
+} // namespace sub_events
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,236 @@
+#include <n4-telemetry.hh>
+
+#include <G4ios.hh>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace telemetry {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+bool   enabled_        = true;
+size_t progress_every_ = 0;
+std::unique_ptr<std::ofstream> json_;
+
+// Bin 0 holds everything below 1 us; bin i > 0 holds [10^((i-1)/20), 10^(i/20)) us
+constexpr size_t bins_per_decade = 20;
+constexpr size_t n_bins          = 1 + 11 * bins_per_decade; // up to 10^5 s
+constexpr double smallest        = 1e-6;
+
+size_t bin_of(double seconds) {
+  if (seconds < smallest) { return 0; }
+  auto bin = 1 + static_cast<size_t>(bins_per_decade * std::log10(seconds / smallest));
+  return std::min(bin, n_bins - 1);
+}
+
+double centre_of(size_t bin) {
+  return smallest * std::pow(10.0, (static_cast<double>(bin) - 0.5) / bins_per_decade);
+}
+
+struct thread_data {
+  std::array<uint64_t, n_bins> counts{};
+  size_t            events = 0;
+  double            sum    = 0;
+  double            max    = 0;
+  clock::time_point event_start;
+};
+
+std::mutex& registry_mutex() { static std::mutex m; return m; }
+std::vector<std::unique_ptr<thread_data>>& registry() {
+  static std::vector<std::unique_ptr<thread_data>> r;
+  return r;
+}
+
+thread_data& local() {
+  thread_local thread_data* mine = nullptr;
+  if (! mine) {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    registry().push_back(std::make_unique<thread_data>());
+    mine = registry().back().get();
+  }
+  return *mine;
+}
+
+// State of the current run, written by the master before any event starts
+clock::time_point   run_start;
+size_t              requested = 0;
+std::atomic<size_t> finished  = 0;
+
+std::optional<summary> last_;
+std::mutex             output_mutex;
+
+long peak_rss_bytes() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss;        // bytes
+#else
+  return usage.ru_maxrss * 1024; // kilobytes
+#endif
+}
+
+double seconds_since(clock::time_point start) {
+  return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+void progress(size_t done) {
+  auto elapsed = seconds_since(run_start);
+  auto rate    = elapsed > 0 ? done / elapsed : 0;
+  auto left    = requested > done ? requested - done : 0;
+  auto eta     = rate > 0 ? left / rate : 0;
+  auto rss     = peak_rss_bytes();
+
+  std::lock_guard<std::mutex> lock{output_mutex};
+  auto precision = G4cout.precision();
+  G4cout << "n4::telemetry: " << done << '/' << requested << " events"
+         << std::fixed << std::setprecision(1)
+         << " (" << (requested ? 100.0 * done / requested : 0) << "%), "
+         << rate << " events/s, ETA " << eta << " s, peak RSS "
+         << rss / (1024.0 * 1024.0) << " MiB"
+         << std::defaultfloat << std::setprecision(precision) << G4endl;
+  if (json_) {
+    *json_ << R"({"type":"progress","events":)" << done
+           << R"(,"events_requested":)"         << requested
+           << R"(,"seconds":)"                  << elapsed
+           << R"(,"events_per_second":)"        << rate
+           << R"(,"eta_seconds":)"              << eta
+           << R"(,"peak_rss_bytes":)"           << rss
+           << "}\n" << std::flush;
+  }
+}
+
+} // anonymous namespace
+
+void switch_on () { enabled_ = true ; }
+void switch_off() { enabled_ = false; }
+bool enabled   () { return enabled_; }
+
+void progress_every(size_t n) { progress_every_ = n; }
+
+void json_lines(std::string const& path) {
+  auto out = std::make_unique<std::ofstream>(path, std::ios::app);
+  if (! *out) {
+    std::cerr << "n4::telemetry: cannot open '" << path << "' for writing" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  json_ = std::move(out);
+}
+
+void json_lines_off() { json_.reset(); }
+
+std::optional<summary> last_run() { return last_; }
+
+void run_started(G4int events_requested) {
+  {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    for (auto& data : registry()) { *data = thread_data{}; }
+  }
+  requested = static_cast<size_t>(std::max(events_requested, 0));
+  finished  = 0;
+  run_start = clock::now();
+}
+
+void event_started() { local().event_start = clock::now(); }
+
+void event_finished() {
+  auto& data    = local();
+  auto  latency = seconds_since(data.event_start);
+  data.counts[bin_of(latency)]++;
+  data.events++;
+  data.sum += latency;
+  data.max  = std::max(data.max, latency);
+
+  auto done = ++finished;
+  if (progress_every_ && done % progress_every_ == 0) { progress(done); }
+}
+
+void run_finished() {
+  summary s;
+  s.events_requested = requested;
+  s.seconds          = seconds_since(run_start);
+  s.peak_rss_bytes   = peak_rss_bytes();
+
+  std::array<uint64_t, n_bins> counts{};
+  {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    for (auto& data : registry()) {
+      for (size_t i=0; i<n_bins; i++) { counts[i] += data -> counts[i]; }
+      s.events       += data -> events;
+      s.latency_mean += data -> sum;
+      s.latency_max   = std::max(s.latency_max, data -> max);
+    }
+  }
+
+  if (s.events) {
+    s.latency_mean /= s.events;
+    auto percentile = [&] (double q) {
+      auto target = static_cast<uint64_t>(std::ceil(q * s.events));
+      uint64_t seen = 0;
+      for (size_t i=0; i<n_bins; i++) {
+        seen += counts[i];
+        if (seen >= target) { return std::min(centre_of(i), s.latency_max); }
+      }
+      return s.latency_max;
+    };
+    s.latency_p50 = percentile(0.50);
+    s.latency_p99 = percentile(0.99);
+  }
+  if (s.seconds > 0) { s.events_per_second = s.events / s.seconds; }
+
+  last_ = s;
+  std::lock_guard<std::mutex> lock{output_mutex};
+  if (progress_every_) { report(G4cout, s); }
+  if (json_)           { write_json(*json_, s); }
+}
+
+void report(std::ostream& out, summary const& s) {
+  auto ms = [] (double seconds) { return seconds * 1e3; };
+  auto precision = out.precision();
+  out << "---- n4::telemetry: " << s.events << " events in "
+      << std::fixed << std::setprecision(3) << s.seconds << " s, "
+      << std::setprecision(1) << s.events_per_second << " events/s ----\n"
+      << std::setprecision(3)
+      << "latency mean " << ms(s.latency_mean) << " ms, p50 " << ms(s.latency_p50)
+      << " ms, p99 "     << ms(s.latency_p99)  << " ms, max " << ms(s.latency_max) << " ms\n"
+      << std::setprecision(1)
+      << "peak RSS "     << s.peak_rss_bytes / (1024.0 * 1024.0) << " MiB\n"
+      << std::defaultfloat << std::setprecision(precision) << std::flush;
+}
+
+void write_json(std::ostream& out, summary const& s) {
+  out << R"({"type":"run","events_requested":)" << s.events_requested
+      << R"(,"events":)"                        << s.events
+      << R"(,"seconds":)"                       << s.seconds
+      << R"(,"events_per_second":)"             << s.events_per_second
+      << R"(,"latency_mean":)"                  << s.latency_mean
+      << R"(,"latency_p50":)"                   << s.latency_p50
+      << R"(,"latency_p99":)"                   << s.latency_p99
+      << R"(,"latency_max":)"                   << s.latency_max
+      << R"(,"peak_rss_bytes":)"                << s.peak_rss_bytes
+      << "}\n" << std::flush;
+}
+
+} // namespace telemetry
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <G4Types.hh>
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace telemetry {
+
+// ---- Event throughput, event latency and memory of each run -----------------------------------------
+// On by default: n4::event_action reads the clock at the start and end of each
+// event, and n4::run_action summarizes at the end of each run. n4::actions
+// installs plain run and event actions if none were given.
+//
+//   n4::telemetry::progress_every(1000);              // or --progress 1000
+//   n4::telemetry::json_lines("telemetry.jsonl");     // or --telemetry telemetry.jsonl
+//   auto rm = n4::run_manager::create() ... .run(n);
+//   std::cout << rm -> telemetry().events_per_second;
+//
+// Latencies are binned into a histogram with 20 logarithmic bins per decade,
+// from 1 microsecond up, so percentiles are accurate to about 6%; the maximum
+// is exact. Each thread accumulates into its own histogram.
+void switch_on ();
+void switch_off();
+bool enabled   ();
+
+// Write a progress line with an ETA to G4cout every `n` events (0: never)
+void progress_every(size_t n);
+// Append one JSON object per progress line, and one per run, to `path`
+void json_lines(std::string const& path);
+void json_lines_off();
+
+struct summary {
+  size_t events_requested  = 0;
+  size_t events            = 0;
+  double seconds           = 0; // wall time from start to end of run
+  double events_per_second = 0;
+  double latency_mean      = 0; // seconds
+  double latency_p50       = 0;
+  double latency_p99       = 0;
+  double latency_max       = 0;
+  long   peak_rss_bytes    = 0; // high-water mark of the whole process
+};
+
+// The last run that finished
+std::optional<summary> last_run();
+void report    (std::ostream&, summary const&);
+void write_json(std::ostream&, summary const&);
+
+// Hooks called by n4::run_action (master thread) and n4::event_action
+void run_started   (G4int events_requested);
+void run_finished  ();
+void event_started ();
+void event_finished();
+
+} // namespace telemetry
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,154 @@
+#include <n4-track-stats.hh>
+
+#include <G4ParticleDefinition.hh>
+#include <G4StackManager.hh>
+#include <G4Track.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace track_stats {
+
+namespace {
+
+bool enabled_ = false;
+
+using clock = std::chrono::steady_clock;
+
+struct thread_data {
+  std::unordered_map<G4ParticleDefinition const*, species> by_particle;
+  size_t            events     = 0;
+  size_t            peak       = 0; // in the current event
+  size_t            max_peak   = 0;
+  size_t            sum_peaks  = 0; // of finished events
+  clock::time_point track_start;
+
+  species& of(G4Track const* track) {
+    auto definition = track -> GetDefinition();
+    auto [it, inserted] = by_particle.try_emplace(definition);
+    if (inserted) { it -> second.particle = definition -> GetParticleName(); }
+    return it -> second;
+  }
+};
+
+std::mutex& registry_mutex() { static std::mutex m; return m; }
+std::vector<std::unique_ptr<thread_data>>& registry() {
+  static std::vector<std::unique_ptr<thread_data>> r;
+  return r;
+}
+
+thread_data& local() {
+  thread_local thread_data* mine = nullptr;
+  if (! mine) {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    registry().push_back(std::make_unique<thread_data>());
+    mine = registry().back().get();
+  }
+  return *mine;
+}
+
+} // anonymous namespace
+
+void switch_on () { enabled_ = true ; }
+void switch_off() { enabled_ = false; }
+bool enabled   () { return enabled_; }
+
+void reset() {
+  std::lock_guard<std::mutex> lock{registry_mutex()};
+  for (auto& data : registry()) { *data = thread_data{}; }
+}
+
+void new_event() {
+  auto& data = local();
+  if (data.events > 0) { data.sum_peaks += data.peak; }
+  data.events++;
+  data.peak = 0;
+}
+
+void classified(G4Track const* track, G4ClassificationOfNewTrack classification, G4StackManager* stack) {
+  auto& data = local();
+  auto& s    = data.of(track);
+  switch (classification) {
+    case fUrgent  : s.urgent  ++; break;
+    case fPostpone: s.postpone++; break;
+    case fKill    : s.kill    ++; break;
+    default       : s.waiting ++; break;
+  }
+  if (stack && classification != fKill) {
+    // The new track is not on the stack yet
+    auto depth = static_cast<size_t>(stack -> GetNTotalTrack()) + 1;
+    data.peak     = std::max(data.peak    , depth);
+    data.max_peak = std::max(data.max_peak, depth);
+  }
+}
+
+void track_started(G4Track const*) { local().track_start = clock::now(); }
+
+void track_finished(G4Track const* track) {
+  auto& data = local();
+  auto& s    = data.of(track);
+  s.tracked++;
+  s.seconds += std::chrono::duration<double>(clock::now() - data.track_start).count();
+}
+
+summary collect() {
+  std::map<std::string, species> merged;
+  summary result{0, 0, 0, {}};
+  size_t sum_peaks = 0;
+  {
+    std::lock_guard<std::mutex> lock{registry_mutex()};
+    for (auto& data : registry()) {
+      result.events           += data -> events;
+      result.peak_stack_depth  = std::max(result.peak_stack_depth, data -> max_peak);
+      sum_peaks               += data -> sum_peaks + data -> peak;
+      for (auto& [_, s] : data -> by_particle) {
+        auto& m = merged[s.particle];
+        m.particle  = s.particle;
+        m.urgent   += s.urgent;
+        m.waiting  += s.waiting;
+        m.postpone += s.postpone;
+        m.kill     += s.kill;
+        m.tracked  += s.tracked;
+        m.seconds  += s.seconds;
+      }
+    }
+  }
+  if (result.events) { result.mean_peak_stack_depth = static_cast<double>(sum_peaks) / result.events; }
+  for (auto& [_, s] : merged) { result.by_species.push_back(s); }
+  std::sort(begin(result.by_species), end(result.by_species), [] (auto& a, auto& b) { return a.seconds > b.seconds; });
+  return result;
+}
+
+void report(std::ostream& out) {
+  auto stats = collect();
+  out << "---- n4::track_stats: " << stats.events << " events, stack depth peak "
+      << stats.peak_stack_depth << ", mean peak " << std::fixed << std::setprecision(1)
+      << stats.mean_peak_stack_depth << " ----\n"
+      << std::setw(15) << "time"   << std::setw(12) << "tracked"
+      << std::setw(12) << "urgent" << std::setw(12) << "waiting"
+      << std::setw(12) << "postpone" << std::setw(12) << "kill" << "  particle\n";
+  for (auto& s : stats.by_species) {
+    out << std::setw(12) << std::setprecision(3) << s.seconds * 1e3 << " ms"
+        << std::setw(12) << s.tracked
+        << std::setw(12) << s.urgent
+        << std::setw(12) << s.waiting
+        << std::setw(12) << s.postpone
+        << std::setw(12) << s.kill
+        << "  " << s.particle << '\n';
+  }
+  out << std::defaultfloat << std::flush;
+}
+
+} // namespace track_stats
+} // namespace nain4
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <G4ClassificationOfNewTrack.hh>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class G4StackManager;
+class G4Track;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+
+namespace nain4 {
+namespace track_stats {
+
+// ---- Stack depth, track counts and tracking time per particle species ------------------------------
+// Off by default, in which case n4::stacking_action and n4::tracking_action pay
+// for a single branch per track. Switch on before the run (or pass
+// --track-stats on the CLI) to find out what fills the stack when events blow
+// up. n4::actions installs plain stacking and tracking actions if none were
+// given, and a run action which reports at the end of each run.
+//
+//   n4::track_stats::switch_on();
+//   ... run_manager ... .run(n);
+//   n4::track_stats::report(std::cout);   // or at any other time
+//
+// Each thread accumulates into its own structure. Statistics are reset at
+// the start of each run.
+void switch_on ();
+void switch_off();
+bool enabled   ();
+void reset     ();
+
+struct species {
+  std::string particle;
+  size_t      urgent   = 0; // as classified on creation
+  size_t      waiting  = 0; // any of the waiting stacks
+  size_t      postpone = 0;
+  size_t      kill     = 0;
+  size_t      tracked  = 0;
+  double      seconds  = 0; // wall time between pre- and post-tracking actions
+};
+
+struct summary {
+  size_t               events;
+  size_t               peak_stack_depth;      // largest in any event
+  double               mean_peak_stack_depth; // per event
+  std::vector<species> by_species;            // sorted by decreasing time
+};
+
+// All threads merged
+summary collect();
+void    report(std::ostream&);
+
+// Hooks called by n4::stacking_action and n4::tracking_action
+void new_event     ();
+void classified    (G4Track const*, G4ClassificationOfNewTrack, G4StackManager*);
+void track_started (G4Track const*);
+void track_finished(G4Track const*);
+
+} // namespace track_stats
+} // namespace nain4
+
+namespace n4 { using namespace nain4; }
+
+#pragma GCC diagnostic pop
@@ -1,5 +1,12 @@
 #include <n4-ui.hh>
+#include <n4-benchmark.hh>
+#include <n4-checkpoint.hh>
+#include <n4-multiprocess.hh>
+#include <n4-sub-events.hh>
 #include <n4-run-manager.hh>
+#include <n4-profile.hh>
+#include <n4-telemetry.hh>
+#include <n4-track-stats.hh>
 
 #include <G4String.hh>
 #include <G4UIExecutive.hh>
@@ -7,6 +14,7 @@
 #include <G4UImanager.hh>
 #include <G4VisExecutive.hh>
 #include <G4VisManager.hh>
+#include <Randomize.hh>
 
 #include <argparse/argparse.hpp>
 
@@ -19,17 +27,28 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 
-unsigned parse_beam_on(const std::string&  arg) {
+unsigned parse_unsigned(const std::string& option, const std::string&  arg) {
   auto parsed = std::stoi(arg.c_str());
-  if (parsed < 0) { throw std::runtime_error{std::string{"--beam-on requires an unsigned integer, you gave '"} + arg + "'"}; }
+  if (parsed < 0) { throw std::runtime_error{option + " requires an unsigned integer, you gave '" + arg + "'"}; }
   return static_cast<unsigned>(parsed);
+}
 
+long parse_long(const std::string& option, const std::string& arg) {
+  try {
+    size_t used;
+    auto parsed = std::stol(arg, &used);
+    if (used == arg.size()) { return parsed; }
+  } catch (const std::logic_error&) {}
+  throw std::runtime_error{option + " requires an integer, you gave '" + arg + "'"};
 }
 
+unsigned parse_beam_on(const std::string&  arg) { return parse_unsigned("--beam-on", arg); }
+
 #define MULTIPLE nargs(argparse::nargs_pattern::at_least_one).append()
 #define ANY      nargs(argparse::nargs_pattern::any         ).append()
 
@@ -45,6 +64,23 @@ nain4::internal::cli_and_err nain4::internal::define_args(const std::string& pro
   cli->add_argument("--macro-path", "-m").metavar("MACROPATHS").help("Add MACROPATHS to Geant4 macro search path").MULTIPLE;
   cli->add_argument("--save-rng").metavar("DIR") .help("Save random number states for each event in DIR");
   cli->add_argument("--with-rng").metavar("FILE").help("Run with random number generator state specified in FILE");
+  cli->add_argument("--check-overlaps").metavar("POINTS").help("Check geometry for overlaps with POINTS surface points per volume, and exit");
+  cli->add_argument("--physics-cache").metavar("DIR").help("Retrieve physics tables from DIR if they were stored there, store them otherwise");
+  cli->add_argument("--profile").help("Report time and heap spent building and initializing the geometry")
+    .default_value(false).implicit_value(true);
+  cli->add_argument("--track-stats").help("Report stack depth, track counts and tracking time per particle at the end of each run")
+    .default_value(false).implicit_value(true);
+  cli->add_argument("--progress").metavar("N").help("Report progress, throughput and ETA every N events, and event latencies at the end of each run");
+  cli->add_argument("--telemetry").metavar("FILE").help("Append progress and end-of-run telemetry to FILE as JSON lines");
+  cli->add_argument("--seed").metavar("SEED").help("Seed the random number generator with SEED before the run");
+  cli->add_argument("--threads").metavar("N").help("Run multi-threaded, with N worker threads (0: sequential)");
+  cli->add_argument("--benchmark").metavar("WARMUP").help("Report startup time and events/s of the run, after WARMUP unmeasured events");
+  cli->add_argument("--checkpoint").metavar("DIR").help("Run in chunks, saving a checkpoint in DIR after each one");
+  cli->add_argument("--chunk-size").metavar("N").help("Events per chunk with --checkpoint (default 10000)");
+  cli->add_argument("--processes").metavar("K").help("Share the events among K forked processes, after building geometry and physics");
+  cli->add_argument("--sub-events").metavar("K").help("Track the optical photons of each event in K sub-events, shared among the worker threads");
+  cli->add_argument("--resume").help("Continue from the last checkpoint in the --checkpoint DIR, if there is one")
+    .default_value(false).implicit_value(true);
 
   try {
     cli->parse_args(argc, argv);
@@ -89,11 +125,44 @@ ui::ui(const std::string& program_name, int argc, char** argv, unique_argparse c
   , use_graphics{cli->is_used("--vis")}
   , rng_out{cli->present("--save-rng")}
   , rng_in {cli->present("--with-rng")}
+  , physics_cache_dir{cli->present("--physics-cache")}
   , argc{argc}
   , argv{argv}
   , g4_ui{*G4UImanager::GetUIpointer()}
 {
-  if (auto n = cli->present("--beam-on")) { n_events  = parse_beam_on(n.value()); }
+  // ui::run hands the events to at most one of these modes
+  std::vector<std::string> modes;
+  for (auto mode : {"--benchmark", "--checkpoint", "--processes"}) {
+    if (cli->is_used(mode)) { modes.push_back(mode); }
+  }
+  if (modes.size() > 1) {
+    std::cerr << modes[0] << " cannot be combined with " << modes[1] << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (auto n = cli->present("--beam-on"       )) { n_events       = parse_beam_on(n.value()); }
+  if (auto n = cli->present("--check-overlaps")) { overlap_points = parse_unsigned("--check-overlaps", n.value()); }
+  if (auto n = cli->present("--threads"       )) { n_threads      = parse_unsigned("--threads"       , n.value()); }
+  if (auto s = cli->present("--seed"          )) { rng_seed       = parse_long    ("--seed"          , s.value()); }
+  if (auto n = cli->present("--benchmark"     )) { benchmark::switch_on(parse_unsigned("--benchmark", n.value())); }
+  if (auto dir = cli->present("--checkpoint")) {
+    auto chunk = cli->present("--chunk-size");
+    checkpoint::switch_on( dir.value()
+                         , chunk ? parse_unsigned("--chunk-size", chunk.value()) : checkpoint::default_chunk_size
+                         , cli->get<bool>("--resume"));
+  }
+  if (auto k = cli->present("--processes")) {
+    if (n_threads.value_or(0) > 0) {
+      std::cerr << "--processes cannot be combined with --threads" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    multiprocess::switch_on(parse_unsigned("--processes", k.value()));
+  }
+  if (auto k = cli->present("--sub-events")) { sub_events::switch_on(parse_unsigned("--sub-events", k.value())); }
+  if (cli->get<bool>("--profile"    )) {     profile::switch_on(); }
+  if (cli->get<bool>("--track-stats")) { track_stats::switch_on(); }
+  if (auto n    = cli->present("--progress" )) { telemetry::progress_every(parse_unsigned("--progress", n.value())); }
+  if (auto file = cli->present("--telemetry")) { telemetry::json_lines(file.value()); }
 
   // Here we use std::string because G4String does not work
   auto macro_paths = cli->get<std::vector<std::string>>("--macro-path");
@@ -108,7 +177,7 @@ ui::ui(const std::string& program_name, int argc, char** argv, unique_argparse c
     if (! macro_file_specified) { items.insert(begin(items), default_vis_macro); }
   }
 
-  if (warn_empty_run && ! (n_events.has_value() || use_graphics)) {
+  if (warn_empty_run && ! (n_events.has_value() || use_graphics || overlap_points.has_value())) {
     std::cerr << "'" + program_name + "' is not going to do anything interesting without --beam-on or --vis.\n\n";
     std::cerr << *cli.get() << std::endl;
   }
@@ -116,6 +185,7 @@ ui::ui(const std::string& program_name, int argc, char** argv, unique_argparse c
 }
 
 void ui::run(std::optional<unsigned> n) {
+  if (rng_seed.has_value()) { G4Random::setTheSeed(rng_seed.value()); }
   if (rng_in .has_value()) { command("/random/resetEngineFrom "  + rng_in .value(), "RNG", kind::command); }
   if (rng_out.has_value()) { command("/random/setDirectoryName " + rng_out.value(), "RNG", kind::command);
                              command("/random/setSavingFlag true"                 , "RNG", kind::command);
@@ -125,7 +195,20 @@ void ui::run(std::optional<unsigned> n) {
   if (n.has_value()) { n_events = static_cast<int>(n.value()); }
 
   if (n_events.has_value() && !use_graphics) {
-    beam_on(n_events.value());
+    // With sub-events, each requested event becomes several Geant4 events
+    auto beam_on_n = [this] (G4int events) {
+      if (sub_events::enabled()) { sub_events::run(events, [this] (G4int g4_events) { beam_on(g4_events); }); }
+      else                       {                                                            beam_on(events); }
+    };
+    // Also when switched on by hand: the constructor only checks the CLI
+    if (benchmark::enabled() + checkpoint::enabled() + multiprocess::enabled() > 1) {
+      std::cerr << "n4::benchmark, n4::checkpoint and n4::multiprocess cannot be combined" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if      (   benchmark::enabled()) {    benchmark::run(n_events.value(), beam_on_n); }
+    else if (  checkpoint::enabled()) {   checkpoint::run(n_events.value(), beam_on_n); }
+    else if (multiprocess::enabled()) { multiprocess::run(n_events.value(), beam_on_n); }
+    else                              {                   beam_on_n(n_events.value()); }
   }
 
   if (use_graphics) {
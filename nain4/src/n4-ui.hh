@@ -70,6 +70,16 @@ public : ui(const std::string& program_name, int argc, char** argv,
   void prepend_path(G4String const& path) { set_path(path + ":" + g4_ui.GetMacroSearchPath(    ));}
 
   std::unordered_map<std::string, std::string> arg_map();
+
+  // Number of surface points requested with --check-overlaps, if any
+  std::optional<unsigned> check_overlaps() const { return overlap_points; }
+  // Directory of the physics table cache (--physics-cache), if any
+  const std::optional<std::string>& physics_cache() const { return physics_cache_dir; }
+  void physics_cache(const std::string& dir) { physics_cache_dir = dir; }
+  // Number of worker threads requested with --threads, if any
+  std::optional<unsigned> threads() const { return n_threads; }
+  // Seed requested with --seed, if any
+  std::optional<long> seed() const { return rng_seed; }
 private:
   friend test::query;
 
@@ -80,6 +90,10 @@ private:
   bool                       use_graphics;
   std::optional<std::string> rng_out;
   std::optional<std::string> rng_in;
+  std::optional<std::string> physics_cache_dir;
+  std::optional<unsigned>    overlap_points;
+  std::optional<unsigned>    n_threads;
+  std::optional<long>        rng_seed;
 
   int    argc;
   char** argv;
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <n4-benchmark.hh>
+#include <n4-checkpoint.hh>
 #include <n4-constants.hh>
+#include <n4-convergence.hh>
 #include <n4-inspect.hh>
+#include <n4-multiprocess.hh>
+#include <n4-profile.hh>
 #include <n4-random.hh>
 #include <n4-stats.hh>
 #include <n4-sequences.hh>
 #include <n4-stream.hh>
+#include <n4-sub-events.hh>
+#include <n4-telemetry.hh>
+#include <n4-track-stats.hh>
@@ -1,4 +1,5 @@
 #include <n4-will-become-external-lib.hh>
+#include <n4-convergence.hh>
 #include <n4-inspect.hh>
 #include <n4-material.hh>
 #include <n4-random.hh>
@@ -6,12 +7,28 @@
 #include <n4-shape.hh>
 #include <n4-stream.hh>
 
+#include <G4EmCalculator.hh>
+#include <G4EmProcessSubType.hh>
+#include <G4Electron.hh>
+#include <G4Event.hh>
+#include <G4Gamma.hh>
+#include <G4HadronicProcessStore.hh>
 #include <G4PrimaryVertex.hh>
+#include <G4ProcessManager.hh>
+#include <G4ProductionCutsTable.hh>
 #include <G4RandomDirection.hh>
+#include <G4VEmProcess.hh>
+#include <G4VEnergyLossProcess.hh>
 #include <G4VUserPhysicsList.hh>
 
+#include <cmath>
 #include <cstddef>
 #include <algorithm>
+#include <climits>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 
 
 // Estimate interaction_lengths based on given configuration
@@ -62,6 +79,17 @@ std::vector<double> measure_interaction_length(interaction_length_config const&
       ;
   };
 
+  // The mean interaction distance is itself an estimate of the interaction length
+  auto n_events = config.n_events;
+  if (config.precision > 0) {
+    auto last_distance = [&observed_interaction_distances, seen = size_t{0}] (G4Event const*) mutable -> std::optional<G4double> {
+      if (observed_interaction_distances.size() == seen) { return {}; }
+      seen = observed_interaction_distances.size();
+      return observed_interaction_distances.back();
+    };
+    n4::convergence::stop_at(config.precision, last_distance);
+  }
+
   // ----- Initialize and run Geant4 -------------------------------------------
   {
     n4::silence _{G4cout};
@@ -73,6 +101,11 @@ std::vector<double> measure_interaction_length(interaction_length_config const&
       .run(config.n_events);
   }
 
+  if (config.precision > 0) {
+    n_events = static_cast<unsigned>(n4::convergence::last_run() -> events);
+    n4::convergence::switch_off();
+  }
+
 
   // Space for the results that will be returned
   auto measured_interaction_lengths = n4::vec_with_capacity<double>(config.distances.size());
@@ -83,7 +116,7 @@ std::vector<double> measure_interaction_length(interaction_length_config const&
     auto interacted_within_distance = std::count_if( cbegin(observed_interaction_distances)
                                                    ,   cend(observed_interaction_distances)
                                                    , [=] (auto d) {return d<distance;});
-    auto ratio     = 1 - interacted_within_distance / static_cast<float>(config.n_events);
+    auto ratio     = 1 - interacted_within_distance / static_cast<float>(n_events);
     auto interaction_length = - distance / log(ratio);
     measured_interaction_lengths.push_back(interaction_length);
   };
@@ -97,57 +130,230 @@ std::vector<double> measure_interaction_length(interaction_length_config const&
   return measured_interaction_lengths;
 }
 
-// ----- Calculate 511 keV gamma interaction process fractions for given material ------------------------------
-interaction_process_fractions calculate_interaction_process_fractions(G4Material* material, G4VUserPhysicsList* physics) {
-  unsigned phot{0}, compt{0}, rayl{0};
+// ----- Interaction lengths from cross sections, without simulating any events --------------------------------
+double calculate_interaction_length(G4ParticleDefinition const* particle, G4Material const* material, double energy) {
+  G4EmCalculator em;
+  auto hadronic = G4HadronicProcessStore::Instance();
+  auto cuts     = G4ProductionCutsTable::GetProductionCutsTable() -> GetDefaultProductionCuts();
+  auto cut_for  = [&] (G4ParticleDefinition const* secondary) {
+    auto range = cuts -> GetProductionCut(secondary -> GetParticleName());
+    return em.ComputeEnergyCutFromRangeCut(range, secondary, material);
+  };
 
-  auto kill_secondaries = [] (const G4Track* track) {
-    return track -> GetParentID() > 0 ? G4ClassificationOfNewTrack::fKill : G4ClassificationOfNewTrack::fUrgent;
+  auto gamma = particle == G4Gamma::Definition();
+  // Gammas may be tracked by a single G4GammaGeneralProcess: ask for its components
+  auto inverse_length = gamma ? 1 / em.ComputeGammaAttenuationLength(energy, material) : 0;
+
+  auto processes = particle -> GetProcessManager() -> GetProcessList();
+  for (size_t i=0; i<processes -> size(); i++) {
+    auto process = (*processes)[i];
+    auto type    = process -> GetProcessType();
+    // Only discrete EM interactions: multiple scattering is a G4VMultipleScattering,
+    // whose cross section is a transport cross section, not an interaction rate;
+    // Cerenkov and scintillation are not cross-section based at all
+    auto discrete = dynamic_cast<G4VEmProcess*>(process) || dynamic_cast<G4VEnergyLossProcess*>(process);
+    if (type == fElectromagnetic && discrete && ! gamma) {
+      auto secondary = process -> GetProcessSubType() == fBremsstrahlung ? G4Gamma::Definition() : G4Electron::Definition();
+      inverse_length += em.ComputeCrossSectionPerVolume(energy, particle, process -> GetProcessName(), material, cut_for(secondary));
+    }
+    if (type == fHadronic) {
+      inverse_length += hadronic -> GetCrossSectionPerVolume(particle, energy, process, material);
+    }
+  }
+  return inverse_length > 0 ? 1 / inverse_length : std::numeric_limits<double>::infinity();
+}
+
+namespace {
+// Geant4 allows a single run manager per process. The first call to
+// calculate_interaction_lengths or calculate_process_fractions creates it,
+// with the physics and threads of its configuration; later calls to either
+// replace its geometry and run `events` events in it.
+void run_shared(G4VUserPhysicsList* physics, unsigned threads, n4::geometry::construct_fn geometry, unsigned events);
+} // anonymous namespace
+
+std::vector<std::vector<double>> calculate_interaction_lengths(interaction_length_table_config const& config) {
+  // Every material must be in the geometry, for its cross section data to be loaded
+  auto boxes_of_all_materials = [materials = config.materials] () {
+    auto side  = 1*m;
+    auto n     = materials.size();
+    auto world = n4::box("world").xyz(side * (n + 1), side, side).volume(n4::material("G4_Galactic"));
+    for (size_t i=0; i<n; i++) {
+      n4::box("material-" + std::to_string(i)).cube(side / 2)
+        .place(materials[i]).in(world).at_x(side * (i - (n - 1) / 2.)).copy_no(static_cast<int>(i)).now();
+    }
+    return n4::place(world).now();
   };
 
-  auto record_process_and_kill = [&phot, &compt, &rayl] (const G4Step* step) {
-    auto process = step -> GetPostStepPoint() -> GetProcessDefinedStep() -> GetProcessName();
-    if (process != "Transportation") {
-      if (process == "compt") { compt++; }
-      if (process == "phot" ) {  phot++; }
-      if (process == "Rayl" ) {  rayl++; }
+  // Running 0 events builds the physics tables
+  run_shared(config.physics, 0, boxes_of_all_materials, 0);
 
-      step -> GetTrack() -> SetTrackStatus(fStopAndKill);
+  auto particle = n4::find_particle(config.particle_name);
+  auto lengths  = n4::vec_with_capacity<std::vector<double>>(config.materials.size());
+  for (auto material : config.materials) {
+    auto& row = lengths.emplace_back(n4::vec_with_capacity<double>(config.energies.size()));
+    for (auto energy : config.energies) {
+      row.push_back(calculate_interaction_length(particle, material, energy));
     }
+  }
+  return lengths;
+}
+
+// ----- Interaction process fractions for many materials and energies -----------------------------------------
+namespace {
+
+// Number of first interactions of each process, for each material and energy
+using process_counts = std::vector<std::map<std::string, size_t>>;
+
+// The calculation in progress. The actions are built once per thread and
+// kept by the run manager across calls, so they find their work here.
+struct process_fractions_job {
+  std::string                particle_name;
+  std::vector<G4ThreeVector> centres;  // of the box of each material
+  std::vector<double>        energies;
+  unsigned                   n_events;
+  process_counts             counts;
+  std::mutex                 mutex;
+};
+
+process_fractions_job* job                 = nullptr;
+bool                   created_run_manager = false;
+
+n4::actions* process_fractions_actions() {
+  struct tally { size_t batch; process_counts counts; G4ParticleDefinition* particle; };
+  auto mine      = std::make_shared<tally>();
+  auto isotropic = n4::random::direction{};
+
+  auto shoot_particle = [mine, isotropic] (G4Event* event) {
+    // Looked up here, once the physics list has built the particles
+    if (! mine -> particle) { mine -> particle = n4::find_particle(job -> particle_name); }
+    auto batch    = static_cast<size_t>(event -> GetEventID()) / job -> n_events;
+    auto n_e      = job -> energies.size();
+    auto p        = job -> energies[batch % n_e] * isotropic.get();
+    auto particle = new G4PrimaryParticle(mine -> particle, p.x(), p.y(), p.z());
+    auto vertex   = new G4PrimaryVertex(job -> centres[batch / n_e], 0);
+    particle -> SetPolarization(isotropic.get());
+    vertex   -> SetPrimary(particle);
+    event    -> AddPrimaryVertex(vertex);
   };
 
-  auto isotropic_511keV_gammas = [] () {
-    auto particle_type = n4::find_particle("gamma");
-    auto energy        = 511 * keV;
-    auto isotropic     = n4::random::direction{};
+  auto clear = [mine] (G4Run const*) {
+    mine -> counts.assign(job -> counts.size(), {});
+    mine -> particle = nullptr;
+  };
+  auto merge = [mine] (G4Run const*) {
+    std::lock_guard<std::mutex> lock{job -> mutex};
+    for (size_t b=0; b<mine -> counts.size(); b++) {
+      for (auto& [process, n] : mine -> counts[b]) { job -> counts[b][process] += n; }
+    }
+  };
 
-    return [energy, particle_type, isotropic] (G4Event* event) {
-      auto r        = isotropic.get() * energy;
-      auto particle = new G4PrimaryParticle{particle_type, r.x(), r.y(), r.z()};
-      auto vertex   = new G4PrimaryVertex{{}, 0};
-      particle -> SetPolarization(isotropic.get());
-      vertex   -> SetPrimary(particle);
-      event    -> AddPrimaryVertex(vertex);
-    };
+  auto find_batch = [mine] (G4Event const* event) {
+    mine -> batch = static_cast<size_t>(event -> GetEventID()) / job -> n_events;
   };
 
-  auto enormous_sphere = [material] () {return n4::sphere("huge").r(1*km).place(material).now();};
+  // The first step ends with an interaction, or with the particle leaving its box
+  auto record_process_and_kill = [mine] (G4Step const* step) {
+    auto process = step -> GetPostStepPoint() -> GetProcessDefinedStep() -> GetProcessName();
+    if (process != "Transportation") { mine -> counts[mine -> batch][process]++; }
+    step -> GetTrack() -> SetTrackStatus(fStopAndKill);
+  };
 
-  // Gather together all the above actions
-  auto test_action = [&] {
-    return  (new n4::actions{isotropic_511keV_gammas()})
-      -> set((new n4::stacking_action{}) -> classify(kill_secondaries))
-      -> set(new n4::stepping_action{record_process_and_kill})
-      ;
+  auto kill_secondaries = [] (G4Track const* track) {
+    return track -> GetParentID() > 0 ? G4ClassificationOfNewTrack::fKill : G4ClassificationOfNewTrack::fUrgent;
   };
 
-  n4::run_manager::create()
+  return (new n4::actions{shoot_particle})
+    -> set((new n4::run_action{}) -> begin(clear) -> end(merge))
+    -> set((new n4::event_action{}) -> begin(find_batch))
+    -> set((new n4::stacking_action{}) -> classify(kill_secondaries))
+    -> set( new n4::stepping_action{record_process_and_kill});
+}
+
+void run_shared(G4VUserPhysicsList* physics, unsigned threads, n4::geometry::construct_fn geometry, unsigned events) {
+  n4::silence _{G4cout};
+  if (created_run_manager) {
+    n4::run_manager::get().reinitialize_geometry(geometry);
+    n4::internal::exit_on_err(n4::run_manager::get_ui().beam_on(static_cast<G4int>(events)));
+    return;
+  }
+  if (n4::run_manager::available()) {
+    std::cerr << "calculate_interaction_lengths and calculate_process_fractions "
+              << "cannot reuse a run manager created elsewhere" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  created_run_manager = true;
+  auto type = threads > 0 ? G4RunManagerType::MTOnly : G4RunManagerType::SerialOnly;
+  n4::run_manager::create(type)
     .fake_ui()
+    .execute([threads] { G4RunManager::GetRunManager() -> SetNumberOfThreads(static_cast<G4int>(threads)); })
     .physics(physics)
-    .geometry(enormous_sphere)
-    .actions(test_action)
-    .run(100'000);
+    .geometry(geometry)
+    .actions(process_fractions_actions)
+    .run(events);
+}
 
-  auto total = static_cast<float>(phot + compt + rayl);
-  return { phot/total, compt/total, rayl/total };
+} // anonymous namespace
+
+std::vector<std::vector<process_fractions>> calculate_process_fractions(process_fractions_config const& config) {
+  auto n_m     = config.materials.size();
+  auto n_e     = config.energies .size();
+  auto batches = n_m * n_e;
+  if (batches * config.n_events > INT_MAX) {
+    std::cerr << "calculate_process_fractions: " << batches << " x " << config.n_events
+              << " events do not fit in one run" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // One box per material, large enough for (almost) every particle to interact
+  // before leaving it, surrounded by vacuum
+  auto half  = 1*km;
+  auto pitch = 3*half;
+  process_fractions_job current{ .particle_name = config.particle_name
+                               , .centres       = {}
+                               , .energies      = config.energies
+                               , .n_events      = config.n_events
+                               , .counts        = process_counts(batches)
+                               , .mutex         = {}};
+  for (size_t m=0; m<n_m; m++) { current.centres.emplace_back(pitch * (m - (n_m - 1) / 2.), 0, 0); }
+  job = &current;
+
+  auto boxes_of_all_materials = [materials = config.materials, centres = current.centres, n_m, half, pitch] () {
+    auto world = n4::box("world").xyz(pitch * n_m, pitch, pitch).volume(n4::material("G4_Galactic"));
+    for (size_t m=0; m<n_m; m++) {
+      n4::box("material-" + std::to_string(m)).cube(2*half)
+        .place(materials[m]).in(world).at(centres[m]).copy_no(static_cast<int>(m)).now();
+    }
+    return n4::place(world).now();
+  };
+
+  run_shared(config.physics, config.threads, boxes_of_all_materials, static_cast<unsigned>(batches * config.n_events));
+  job = nullptr;
+
+  auto fractions = n4::vec_with_capacity<std::vector<process_fractions>>(n_m);
+  for (size_t m=0; m<n_m; m++) {
+    auto& row = fractions.emplace_back(n_e);
+    for (size_t e=0; e<n_e; e++) {
+      auto& counts = current.counts[m * n_e + e];
+      size_t total = 0;
+      for (auto& [_, n] : counts) { total += n; }
+      for (auto& [process, n] : counts) {
+        auto f = n / static_cast<double>(total);
+        row[e][process] = {f, std::sqrt(f * (1 - f) / total)};
+      }
+    }
+  }
+  return fractions;
+}
+
+// ----- Calculate 511 keV gamma interaction process fractions ------------------------------
+interaction_process_fractions calculate_interaction_process_fractions(G4Material* material, G4VUserPhysicsList* physics) {
+  auto fractions = calculate_process_fractions({ .physics   = physics
+                                               , .materials = {material}
+                                               , .energies  = {511 * keV}
+                                               })[0][0];
+  auto fraction_of = [&fractions] (std::string const& process) {
+    auto found = fractions.find(process);
+    return found == fractions.end() ? 0 : found -> second.fraction;
+  };
+  return { fraction_of("phot"), fraction_of("compt"), fraction_of("Rayl") };
 }
@@ -4,6 +4,10 @@
 #include <G4ParticleDefinition.hh>
 #include <G4VUserPhysicsList.hh>
 
+#include <map>
+#include <string>
+#include <vector>
+
 // Configuration of abslength estimation: use with `measure_abslength`
 struct interaction_length_config {
   G4VUserPhysicsList* physics;
@@ -12,11 +16,59 @@ struct interaction_length_config {
   double              particle_energy;
   std::vector<double> distances;
   unsigned            n_events;
+  double              precision = 0; // stop before n_events once the mean interaction
+                                     // distance has this relative error (0: never)
 };
 
 // Estimate interaction_lengths based on given configuration
 std::vector<double> measure_interaction_length(interaction_length_config const&);
 
+// ----- Interaction lengths from cross sections, without simulating any events --------------------------------
+// Sum of the macroscopic cross sections of all the processes of `particle`,
+// inverted. Needs initialized physics: use inside a running application, or
+// after a run manager has run (even 0 events). Charged particles only count
+// discrete interactions, producing secondaries above the default production
+// cuts: multiple scattering is not an interaction, and is left out.
+double calculate_interaction_length(G4ParticleDefinition const*, G4Material const*, double energy);
+
+// Configuration of interaction length tables: use with `calculate_interaction_lengths`
+struct interaction_length_table_config {
+  G4VUserPhysicsList*      physics;  // ignored if the shared run manager already exists
+  std::vector<G4Material*> materials;
+  std::string              particle_name;
+  std::vector<double>      energies;
+};
+
+// Initializes the physics and returns lengths[m][e]: interaction length in
+// materials[m] at energies[e]. Much faster than measure_interaction_length,
+// which remains as a cross-check. Shares its run manager with
+// calculate_process_fractions: whichever is called first creates it, with
+// its physics, and later calls to either reuse it, ignoring their physics.
+std::vector<std::vector<double>> calculate_interaction_lengths(interaction_length_table_config const&);
+
 // ----- Calculate 511 keV gamma interaction process fractions for given material ------------------------------
 struct interaction_process_fractions { double photoelectric, compton, rayleigh; };
 interaction_process_fractions calculate_interaction_process_fractions(G4Material*, G4VUserPhysicsList*);
+
+// ----- Interaction process fractions for many materials and energies -----------------------------------------
+// Configuration of batched process fractions: use with `calculate_process_fractions`
+struct process_fractions_config {
+  G4VUserPhysicsList*      physics;                  // ignored after the first call
+  std::vector<G4Material*> materials;
+  std::vector<double>      energies;
+  std::string              particle_name = "gamma";
+  unsigned                 n_events      = 100'000;  // per material and energy
+  unsigned                 threads       = 0;        // 0: sequential; ignored after the first call
+};
+
+// Fraction of first interactions due to one process, with its binomial uncertainty
+struct process_fraction { double fraction, error; };
+using process_fractions = std::map<std::string, process_fraction>;
+
+// Fractions of first interactions, by process name, of particles shot
+// isotropically in each material at each energy: result[m][e]. All
+// combinations are simulated in a single run, split among the worker
+// threads. The first call creates the run manager, later calls (and those
+// to calculate_interaction_lengths) reuse it and its physics, so it cannot be
+// combined with other run managers.
+std::vector<std::vector<process_fractions>> calculate_process_fractions(process_fractions_config const&);
@@ -0,0 +1,55 @@
+#include "testing.hh"
+
+#include <n4-benchmark.hh>
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+namespace {
+
+auto water_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_WATER")).now(); }
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 10*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("nain benchmark", "[nain][benchmark]") {
+  n4::run_manager* rm;
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--benchmark", "2", "--seed", "1234", "-n", "3"};
+    rm = n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions(electron_at_origin)
+      .run();
+  }
+  n4::benchmark::switch_off();
+
+  CHECK(G4Random::getTheSeed() == 1234);
+
+  auto bench = n4::benchmark::last();
+  REQUIRE(bench.has_value());
+  CHECK(bench -> mode              == "sequential");
+  CHECK(bench -> threads           == 1);
+  CHECK(bench -> warmup_events     == 2);
+  CHECK(bench -> events            == 3);
+  CHECK(bench -> geometry_seconds  >  0);
+  CHECK(bench -> physics_seconds   >  0);
+  CHECK(bench -> startup_seconds   >= bench -> geometry_seconds + bench -> physics_seconds);
+  CHECK(bench -> seconds           >  0);
+  CHECK(bench -> events_per_second >  0);
+
+  // The last run is the measured one
+  CHECK(rm -> telemetry().events == 3);
+}
@@ -1,6 +1,9 @@
 #include "testing.hh"
 
 #include <n4-boolean-shape.hh>
+#include <n4-cached-extent.hh>
+
+#include <catch2/generators/catch_generators.hpp>
 
 void check_solid_volume_placed_equivalence(G4VSolid* solid, G4LogicalVolume* volume, G4PVPlacement* placed, double tol) {
   CHECK_THAT(volume -> GetMass()        / kg, WithinRel(placed -> GetLogicalVolume() -> GetMass()        / kg, tol));
@@ -335,3 +338,92 @@ TEST_CASE("boolean transform", "[boolean][transform]") {
   CHECK_THAT( usolid2 -> EstimateCubicVolume(n, eps) / m3, WithinRel(3*vbox/4 / m3, 3e-3));
   CHECK_THAT( usolid2 -> EstimateCubicVolume(n, eps) / m3, WithinRel(3*vbox/4 / m3, 3e-3));
 }
+
+TEST_CASE("nain boolean multi_union", "[nain][geometry][boolean][multi_union]") {
+  auto l        = 1*m;
+  auto sep      = 3*l;
+  auto n        = 5;
+  auto balanced = GENERATE(false, true);
+
+  // Every component is displaced, so that the balanced tree has to compose
+  // the transformations of both children at every level.
+  auto row = n4::multi_union("row");
+  for (auto i=1; i<=n; i++) { row.add(n4::box("cube").cube(l)).at_x(i*sep); }
+  if (balanced) { row.balanced(); }
+  auto solid = row.solid();
+
+  CHECK(row.size() == static_cast<size_t>(n));
+  CHECK(solid -> GetName() == "row");
+  for (auto i=1; i<=n; i++) {
+    CHECK(solid -> Inside({ i       * sep, 0, 0}) == kInside );
+    CHECK(solid -> Inside({(i + .5) * sep, 0, 0}) == kOutside);
+  }
+  CHECK_THAT(solid -> EstimateCubicVolume(1'000'000, 1e-3) / m3, WithinRel(n * l*l*l / m3, 1e-2));
+}
+
+TEST_CASE("nain boolean multi_union rotation", "[nain][geometry][boolean][multi_union]") {
+  auto l        = 1*m;
+  auto sep      = 5*l;
+  auto balanced = GENERATE(false, true);
+
+  auto rods = n4::multi_union("rods")
+    .add(n4::box("rod").xyz(3*l, l/10, l/10))
+    .add(n4::box("rod").xyz(3*l, l/10, l/10)).rot_z(90*deg).at_x(sep)
+    .add(n4::box("rod").xyz(3*l, l/10, l/10))               .at_x(2*sep);
+  if (balanced) { rods.balanced(); }
+  auto solid = rods.solid();
+
+  CHECK(solid -> Inside({  1.2*l     , 0    , 0}) == kInside );
+  CHECK(solid -> Inside({sep         , 1.2*l, 0}) == kInside );
+  CHECK(solid -> Inside({sep + 1.2*l , 0    , 0}) == kOutside);
+  CHECK(solid -> Inside({2*sep + 1.2*l, 0   , 0}) == kInside );
+}
+
+TEST_CASE("nain boolean subtract_all", "[nain][geometry][boolean][subtract_all]") {
+  auto hole  = n4::tubs("hole").r(1*cm).z(2*cm);
+  auto xs    = {-20*cm, 0*cm, 20*cm};
+  auto holes = n4::multi_union("holes");
+  for (auto x : xs) { holes.add(hole).at_x(x); }
+
+  auto plate = n4::box("plate").xy(1*m).z(1*cm).subtract_all(holes).name("perforated").solid();
+
+  CHECK(plate -> GetName() == "perforated");
+  for (auto x : xs) {
+    CHECK(plate -> Inside({x       , 0, 0}) == kOutside);
+    CHECK(plate -> Inside({x + 5*cm, 0, 0}) == kInside );
+  }
+}
+
+TEST_CASE("nain boolean cache_extent", "[nain][geometry][boolean][cache_extent]") {
+  auto r     = 1*m;
+  auto lens  = [&] { return n4::sphere("left").r(r).intersect(n4::sphere("right").r(r)).at_x(1.5*r); };
+  auto plain = lens()               .name("lens").solid();
+  auto fast  = lens().cache_extent().name("lens").solid();
+
+  auto cached = dynamic_cast<n4::cached_extent_solid*>(fast);
+  REQUIRE(cached);
+  CHECK(cached                  -> GetName() == "lens");
+  CHECK(cached -> constituent() -> GetName() == "lens-inner");
+
+  G4ThreeVector min, max;
+  fast -> BoundingLimits(min, max);
+  CHECK_THAT(min.x() / m, WithinRel(0.5 * r / m, 1e-6));
+  CHECK_THAT(max.x() / m, WithinRel(1.0 * r / m, 1e-6));
+
+  for (auto x = -2*r; x <= 3*r; x += r/7) {
+    for (auto y = -2*r; y <= 2*r; y += r/7) {
+      auto p = G4ThreeVector{x, y, r/13};
+      CHECK(fast -> Inside(p) == plain -> Inside(p));
+      if (plain -> Inside(p) == kOutside) {
+        CHECK(fast -> DistanceToIn(p) <= plain -> DistanceToIn(p));
+      }
+    }
+  }
+
+  auto far  = G4ThreeVector{-5*r, 0, 0};
+  auto hit  = G4ThreeVector{ 1, 0, 0};
+  auto miss = G4ThreeVector{ 0, 1, 0};
+  CHECK     (fast -> DistanceToIn(far, miss) == kInfinity);
+  CHECK_THAT(fast -> DistanceToIn(far, hit ) / m, WithinRel(plain -> DistanceToIn(far, hit) / m, 1e-9));
+  CHECK_THAT(fast -> GetCubicVolume()        / m3, WithinRel(plain -> GetCubicVolume()      / m3, 1e-2));
+}
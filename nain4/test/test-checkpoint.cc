@@ -0,0 +1,160 @@
+#include "testing.hh"
+
+#include <n4-checkpoint.hh>
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4RunManager.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto water_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_WATER")).now(); }
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 10*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+std::filesystem::path fresh(std::string const& name) {
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(path);
+  return path;
+}
+
+size_t count_lines(std::filesystem::path const& path) {
+  std::ifstream in{path};
+  std::string line;
+  size_t n = 0;
+  while (std::getline(in, line)) { n++; }
+  return n;
+}
+
+} // namespace
+
+TEST_CASE("checkpoint resume", "[checkpoint]") {
+  auto dir = fresh("n4-test-checkpoint");
+  auto out = fresh("n4-test-checkpoint.txt");
+
+  // Stand-in for beamOn: one random number and one line of output per event
+  size_t              events = 0;
+  std::vector<double> randoms;
+  auto beam_on = [&] (G4int n) {
+    std::ofstream file{out, std::ios::app};
+    for (G4int i=0; i<n; i++) {
+      events++;
+      randoms.push_back(G4UniformRand());
+      file << events << '\n';
+    }
+  };
+
+  auto setup = [&] (bool resume) {
+    n4::checkpoint::switch_off();
+    n4::checkpoint::switch_on(dir.string(), 10, resume);
+    n4::checkpoint::accumulator("events", events);
+    n4::checkpoint::output_file(out.string());
+  };
+
+  G4Random::setTheSeed(1234);
+  std::vector<double> expected;
+  for (size_t i=0; i<25; i++) { expected.push_back(G4UniformRand()); }
+
+  // Killed after simulating the second chunk, but before its checkpoint
+  G4Random::setTheSeed(1234);
+  setup(false);
+  struct killed {};
+  CHECK_THROWS_AS(n4::checkpoint::run(25, [&] (G4int n) { beam_on(n); if (events == 20) { throw killed{}; } }), killed);
+  CHECK(count_lines(out) == 20);
+
+  // State that should be overwritten by the checkpoint
+  events = 666;
+  G4Random::setTheSeed(666);
+  randoms.resize(10);
+
+  setup(true);
+  n4::checkpoint::run(25, beam_on);
+  CHECK(events                           == 25);
+  CHECK(n4::checkpoint::events_done()    == 25);
+  CHECK(count_lines(out)                 == 25);
+  CHECK(randoms                          == expected);
+
+  // Nothing left to do
+  setup(true);
+  n4::checkpoint::run(25, beam_on);
+  CHECK(events == 25);
+  n4::checkpoint::switch_off();
+}
+
+TEST_CASE("checkpoint cli", "[checkpoint][nain]") {
+  auto dir = fresh("n4-test-checkpoint-cli");
+
+  size_t events = 0, runs = 0;
+  auto count_events = [&] (G4Event const*) { events++; };
+  auto count_runs   = [&] (G4Run   const*) { runs++; };
+  n4::checkpoint::accumulator("events", events);
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--checkpoint", dir.c_str(), "--chunk-size", "4", "-n", "10"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions([&] {
+        return (new n4::actions{electron_at_origin})
+          -> set((new n4::event_action) -> end(count_events))
+          -> set((new n4::run_action  ) -> end(count_runs  ));
+      })
+      .run();
+  }
+
+  CHECK(n4::checkpoint::enabled());
+  CHECK(events == 10);
+  CHECK(runs   ==  3);
+  CHECK(std::filesystem::exists(dir / "state"));
+  CHECK(std::filesystem::exists(dir / "rng-3"));
+  CHECK(std::filesystem::exists(dir / "accumulator-events-3"));
+  CHECK(! std::filesystem::exists(dir / "rng-2"));
+  n4::checkpoint::switch_off();
+}
+
+TEST_CASE("checkpoint aborted run", "[checkpoint][nain]") {
+  auto dir = fresh("n4-test-checkpoint-abort");
+
+  size_t events = 0, runs = 0;
+  auto abort_at_6 = [&] (G4Event const*) {
+    if (++events == 6) { G4RunManager::GetRunManager() -> AbortRun(true); }
+  };
+  auto count_runs = [&] (G4Run const*) { runs++; };
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--checkpoint", dir.c_str(), "--chunk-size", "4", "-n", "10"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions([&] {
+        return (new n4::actions{electron_at_origin})
+          -> set((new n4::event_action) -> end(abort_at_6))
+          -> set((new n4::run_action  ) -> end(count_runs));
+      })
+      .run();
+  }
+
+  // Only the events that were simulated are recorded, and no chunk follows
+  CHECK(events                        == 6);
+  CHECK(runs                          == 2);
+  CHECK(n4::checkpoint::events_done() == 6);
+  n4::checkpoint::switch_off();
+}
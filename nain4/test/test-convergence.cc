@@ -0,0 +1,76 @@
+#include "testing.hh"
+
+#include <n4-convergence.hh>
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+
+#include <G4Geantino.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <optional>
+
+namespace {
+
+auto air_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_AIR")).now(); }
+
+void geantino_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Geantino::Definition(), 1*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+// Alternates between 1 and 2: mean 1.5, standard deviation 0.5, so the
+// relative error of the mean drops below 1% after about 1100 events
+std::optional<G4double> one_or_two(G4Event const* event) { return 1 + event -> GetEventID() % 2; }
+
+} // namespace
+
+TEST_CASE("nain convergence", "[nain][convergence]") {
+  n4::convergence::stop_at(0.01, one_or_two);
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(air_cube)
+      .actions(geantino_at_origin)
+      .run(100'000);
+  }
+
+  auto first = n4::convergence::last_run();
+  REQUIRE(first.has_value());
+  CHECK(first -> converged);
+  CHECK(first -> events >  1000);
+  CHECK(first -> events <  1200);
+  CHECK(first -> events == first -> estimate.count());
+  CHECK_THAT(first -> estimate.mean          ().value(), WithinRel(1.5 , 0.01));
+  CHECK     (first -> estimate.relative_error().value() <= 0.01);
+
+  // Stops at the number of events requested, if the target cannot be reached
+  n4::convergence::stop_at(1e-6, one_or_two);
+  {
+    auto hush = n4::silence{std::cout};
+    n4::run_manager::get_ui().run(500);
+  }
+
+  auto second = n4::convergence::last_run();
+  CHECK(! second -> converged);
+  CHECK(  second -> events == 500);
+
+  // Events for which the estimator returns nothing are left out
+  n4::convergence::stop_at(0.01, [] (G4Event const*) { return std::nullopt; });
+  {
+    auto hush = n4::silence{std::cout};
+    n4::run_manager::get_ui().run(200);
+  }
+
+  auto third = n4::convergence::last_run();
+  CHECK(! third -> converged);
+  CHECK(  third -> events           == 200);
+  CHECK(  third -> estimate.count() ==   0);
+  n4::convergence::switch_off();
+}
@@ -1,9 +1,15 @@
 #include <n4-all.hh>
 #include <n4-will-become-external-lib.hh>
 
+#include <G4Electron.hh>
+#include <G4EmCalculator.hh>
+#include <G4Gamma.hh>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
+#include <cmath>
+
 using Catch::Matchers::WithinRel;
 
 TEST_CASE("interaction length") {
@@ -20,3 +26,171 @@ TEST_CASE("interaction length") {
     CHECK_THAT(l, WithinRel(12.5*mm, 0.02));
   }
 }
+
+TEST_CASE("interaction length to target precision") {
+  interaction_length_config config {
+    .physics         = n4::test::default_physics_lists(),
+    .material        = n4::material("G4_Pb"),
+    .particle_name   = "gamma",
+    .particle_energy = 1 * MeV,
+    .distances       = n4::scale_by(1*mm, {5, 10, 15}),
+    .n_events        = 100'000,
+    .precision       = 0.01
+  };
+
+  auto lengths = measure_interaction_length(config);
+
+  // The interaction distances are exponential: 1% needs about 10'000 events
+  auto run = n4::convergence::last_run();
+  REQUIRE(run.has_value());
+  CHECK(run -> converged);
+  CHECK(run -> events < 12'000);
+  CHECK(! n4::convergence::enabled());
+  for (auto l: lengths) {
+    CHECK_THAT(l, WithinRel(12.5*mm, 0.05));
+  }
+}
+
+TEST_CASE("interaction length calculated") {
+  interaction_length_table_config config {
+    .physics       = n4::test::default_physics_lists(),
+    .materials     = {n4::material("G4_Pb"), n4::material("G4_WATER")},
+    .particle_name = "gamma",
+    .energies      = n4::scale_by(MeV, {0.1, 1, 10})
+  };
+
+  auto lengths = calculate_interaction_lengths(config);
+  REQUIRE(lengths.size() == 2);
+  for (auto& row : lengths) { REQUIRE(row.size() == 3); }
+
+  CHECK_THAT(lengths[0][1], WithinRel(12.5*mm, 0.02));
+  // Lead is denser and has a higher Z than water
+  for (size_t e=0; e<3; e++) { CHECK(lengths[0][e] < lengths[1][e]); }
+  // Attenuation in water keeps falling up to well beyond 10 MeV
+  CHECK(lengths[1][0] < lengths[1][1]);
+  CHECK(lengths[1][1] < lengths[1][2]);
+}
+
+TEST_CASE("interaction length calculated for charged particles") {
+  auto water = n4::material("G4_WATER");
+  interaction_length_table_config config {
+    .physics       = n4::test::default_physics_lists(),
+    .materials     = {water},
+    .particle_name = "e-",
+    .energies      = n4::scale_by(MeV, {1, 10})
+  };
+
+  auto lengths = calculate_interaction_lengths(config);
+  REQUIRE(lengths.size() == 1);
+  REQUIRE(lengths[0].size() == 2);
+
+  // Ionisation, bremsstrahlung and e+e- pair production above the default
+  // 0.7 mm cuts. Multiple scattering, whose transport cross section would
+  // bring this down to microns, is not an interaction
+  G4EmCalculator em;
+  auto electron = n4::find_particle("e-");
+  auto cut_e    = em.ComputeEnergyCutFromRangeCut(0.7*mm, G4Electron::Definition(), water);
+  auto cut_g    = em.ComputeEnergyCutFromRangeCut(0.7*mm, G4Gamma   ::Definition(), water);
+  for (size_t e=0; e<2; e++) {
+    auto energy   = config.energies[e];
+    auto expected = 1 / ( em.ComputeCrossSectionPerVolume(energy, electron, "eIoni", water, cut_e)
+                        + em.ComputeCrossSectionPerVolume(energy, electron, "eBrem", water, cut_g)
+                        + em.ComputeCrossSectionPerVolume(energy, electron, "ePairProd", water, cut_e));
+    CHECK_THAT(lengths[0][e], WithinRel(expected, 1e-3));
+    CHECK     (lengths[0][e] > 1*mm);
+  }
+}
+
+TEST_CASE("interaction length calculated agrees with measured") {
+  interaction_length_config config {
+    .physics         = n4::test::default_physics_lists(),
+    .material        = n4::material("G4_WATER"),
+    .particle_name   = "gamma",
+    .particle_energy = 511 * keV,
+    .distances       = n4::scale_by(cm, {5, 10, 20}),
+    .n_events        = 100'000
+  };
+
+  // The measurement leaves the physics initialized
+  auto measured   = measure_interaction_length(config);
+  auto calculated = calculate_interaction_length(n4::find_particle("gamma"), config.material, config.particle_energy);
+  for (auto l: measured) {
+    CHECK_THAT(l, WithinRel(calculated, 0.02));
+  }
+}
+
+TEST_CASE("process fractions batched") {
+  auto lead  = n4::material("G4_Pb");
+  auto water = n4::material("G4_WATER");
+  process_fractions_config config {
+    .physics   = n4::test::default_physics_lists(),
+    .materials = {lead, water},
+    .energies  = {511*keV, 2*MeV},
+    .n_events  = 10'000,
+    .threads   = 2
+  };
+
+  auto fractions = calculate_process_fractions(config);
+  REQUIRE(fractions.size() == 2);
+  for (auto& row : fractions) {
+    REQUIRE(row.size() == 2);
+    for (auto& by_process : row) {
+      auto total = 0.0;
+      for (auto& [_, f] : by_process) {
+        total += f.fraction;
+        CHECK(f.error >  0   );
+        CHECK(f.error <  0.01);
+      }
+      CHECK_THAT(total, WithinRel(1, 1e-9));
+    }
+  }
+
+  auto& pb_511  = fractions[0][0];
+  auto& pb_2MeV = fractions[0][1];
+  auto& h2o_511 = fractions[1][0];
+  CHECK(h2o_511.at("compt").fraction > 0.9);
+  CHECK( pb_511.at("phot" ).fraction > h2o_511.at("phot").fraction);
+  CHECK(! pb_511 .contains("conv"));
+  CHECK(  pb_2MeV.contains("conv"));
+
+  // Later calls reuse the physics
+  config.materials = {water};
+  config.energies  = {511*keV};
+  auto again = calculate_process_fractions(config)[0][0].at("compt");
+  auto first = h2o_511.at("compt");
+  CHECK(std::abs(again.fraction - first.fraction) < 5 * std::hypot(again.error, first.error));
+}
+
+TEST_CASE("interaction lengths and process fractions share a run manager") {
+  auto water   = n4::material("G4_WATER");
+  auto physics = n4::test::default_physics_lists();
+
+  auto lengths = calculate_interaction_lengths({ .physics       = physics
+                                               , .materials     = {water}
+                                               , .particle_name = "gamma"
+                                               , .energies      = {511*keV}
+                                               });
+
+  auto fractions = calculate_process_fractions({ .physics   = physics
+                                               , .materials = {water}
+                                               , .energies  = {511*keV}
+                                               , .n_events  = 10'000
+                                               })[0][0];
+  CHECK(fractions.at("compt").fraction > 0.9);
+
+  // And the other way round
+  auto again = calculate_interaction_lengths({ .physics       = physics
+                                             , .materials     = {water}
+                                             , .particle_name = "gamma"
+                                             , .energies      = {511*keV}
+                                             });
+  CHECK_THAT(again[0][0], WithinRel(lengths[0][0], 1e-9));
+}
+
+TEST_CASE("interaction process fractions 511 keV") {
+  // The first call creates the run manager: the gamma must be looked up after that
+  auto fractions = calculate_interaction_process_fractions(n4::material("G4_WATER"), n4::test::default_physics_lists());
+  CHECK(fractions.compton > 0.9);
+  CHECK(fractions.photoelectric < fractions.rayleigh);
+  CHECK_THAT(fractions.photoelectric + fractions.compton + fractions.rayleigh, WithinRel(1, 1e-9));
+}
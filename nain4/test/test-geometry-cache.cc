@@ -0,0 +1,75 @@
+#include "testing.hh"
+
+#include <n4-geometry-cache.hh>
+
+#include <G4GeometryManager.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4SolidStore.hh>
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+void forget_geometry() {
+  G4GeometryManager::GetInstance() -> OpenGeometry();
+  G4PhysicalVolumeStore::Clean();
+  G4LogicalVolumeStore ::Clean();
+  G4SolidStore         ::Clean();
+}
+
+}
+
+TEST_CASE("nain cached geometry", "[nain][geometry][cache]") {
+  auto dir = (std::filesystem::temp_directory_path() / "n4-test-geometry-cache").string();
+  std::filesystem::remove_all(dir);
+
+  unsigned calls = 0;
+  auto detector  = new n4::sensitive_detector{"detector", [] (auto) { return true; }};
+  auto build = [&] {
+    calls++;
+    auto air   = n4::material("G4_AIR");
+    auto water = n4::material("G4_WATER");
+    auto world = n4::box("world").cube(1*m).place(air).now();
+    n4::box("target").cube(10*cm).sensitive(detector).place(water).in(world).now();
+    return world;
+  };
+
+  auto cold = n4::cached_geometry{dir, "test", build};
+  auto cold_world = cold.Construct();
+  CHECK(! cold.loaded());
+  CHECK(calls == 1);
+  CHECK(std::filesystem::exists(cold.path() + ".gdml"));
+  CHECK(std::filesystem::exists(cold.path() + ".fnv1a"));
+
+  auto n_daughters = cold_world -> GetLogicalVolume() -> GetNoDaughters();
+  forget_geometry();
+
+  auto warm = n4::cached_geometry{dir, "test", build};
+  auto warm_world = warm.Construct();
+  CHECK(warm.loaded());
+  CHECK(calls == 1);
+  CHECK(warm.path() == cold.path());
+  CHECK(warm_world -> GetName() == "world");
+  REQUIRE(warm_world -> GetLogicalVolume() -> GetNoDaughters() == n_daughters);
+
+  auto target = warm_world -> GetLogicalVolume() -> GetDaughter(0) -> GetLogicalVolume();
+  CHECK(target -> GetName()                == "target");
+  CHECK(target -> GetMaterial() -> GetName() == "G4_WATER");
+  CHECK(target -> GetSensitiveDetector()   == detector);
+
+  // A different key does not reuse the snapshot
+  auto other = n4::cached_geometry{dir, "other", build};
+  CHECK(other.path() != cold.path());
+
+  // A corrupted snapshot is rebuilt
+  forget_geometry();
+  std::ofstream{cold.path() + ".gdml", std::ios::app} << "<!-- tampered -->";
+  auto rebuilt = n4::cached_geometry{dir, "test", build};
+  rebuilt.Construct();
+  CHECK(! rebuilt.loaded());
+  CHECK(calls == 2);
+
+  std::filesystem::remove_all(dir);
+}
@@ -2,6 +2,8 @@
 
 #include <catch2/generators/catch_generators.hpp>
 
+#include <cmath>
+
 TEST_CASE("nain material", "[nain][material]") {
 
   // nain4::material finds the same materials as the verbose G4 style
@@ -132,6 +134,32 @@ TEST_CASE("nain material", "[nain][material]") {
   }
 }
 
+constexpr auto fr4_spec  = n4::material_spec_N("n4test_FR4_spec" , 1.85*g/cm3, {{"H", 12}, {"C", 18}, {"O", 3}},
+                                                {.state=kStateSolid});
+constexpr auto lyso_spec = n4::material_spec_F("n4test_LYSO_spec", 7.1 *g/cm3,
+                                                {{"Lu", 0.71}, {"Y", 0.04}, {"Si", 0.064}, {"O", 0.186}});
+
+TEST_CASE("nain material_from spec", "[nain][material]") {
+  auto fr4 = n4::material_from<fr4_spec>();
+  REQUIRE(fr4 != nullptr);
+  CHECK  (fr4 == n4::material_from<fr4_spec>());
+  CHECK  (fr4 == n4::material("n4test_FR4_spec"));
+
+  CHECK     (fr4 -> GetNumberOfElements() == 3);
+  CHECK     (fr4 -> GetElement(0) == n4::element("H"));
+  CHECK     (fr4 -> GetElement(1) == n4::element("C"));
+  CHECK     (fr4 -> GetElement(2) == n4::element("O"));
+  CHECK     (fr4 -> GetAtomsVector()[1] == 18);
+  CHECK     (fr4 -> GetState() == kStateSolid);
+  CHECK_THAT(fr4 -> GetDensity(), Within1ULP(1.85*g/cm3));
+
+  auto lyso  = n4::material_from<lyso_spec>();
+  auto fracs = lyso -> GetFractionVector();
+  CHECK     (lyso -> GetElement(0) == n4::element("Lu"));
+  CHECK_THAT(fracs[0], Within1ULP(0.71));
+  CHECK_THAT(fracs[3], Within1ULP(0.186));
+}
+
 TEST_CASE("nain material_properties", "[nain][material_properties]") {
   SECTION("add") {
     auto key_1         = "RINDEX";
@@ -310,3 +338,50 @@ TEST_CASE("nain material_properties", "[nain][material_properties]") {
     CHECK( mp2 -> GetProperty(key_6)  ==  mp1 -> GetProperty(key_6) );
   }
 }
+
+TEST_CASE("nain define_material", "[nain][material]") {
+  auto name    = "n4-test-lazy-water";
+  auto n_built = 0;
+  n4::define_material(name, [&] {
+    n_built++;
+    auto water = n4::material("G4_WATER");
+    return n4::material_from_elements_N(name, water -> GetDensity(), {.state=kStateLiquid},
+                                        {{"H", 2}, {"O", 1}});
+  });
+
+  CHECK( n_built == 0 );
+  auto water = n4::material(name);
+  CHECK( n_built == 1 );
+  CHECK( water -> GetName() == name );
+  CHECK( n4::material(name) == water );
+  CHECK( n_built == 1 );
+
+  // While it is being defined, a name refers to the NIST material
+  n4::define_material("G4_lAr", [] {
+    auto argon = n4::material("G4_lAr");
+    argon -> SetMaterialPropertiesTable(n4::material_properties().add("RINDEX", {1., 10.}, 1.23).done());
+    return argon;
+  });
+  auto argon = n4::material("G4_lAr");
+  CHECK( argon == G4NistManager::Instance() -> FindOrBuildMaterial("G4_lAr") );
+  REQUIRE( argon -> GetMaterialPropertiesTable() );
+  CHECK_THAT( argon -> GetMaterialPropertiesTable() -> GetProperty("RINDEX") -> Value(5.), Within1ULP(1.23) );
+}
+
+TEST_CASE("nain material_properties fast_lookup", "[nain][material_properties]") {
+  auto energies = std::vector<G4double>{};
+  auto values   = std::vector<G4double>{};
+  for (auto i=0; i<100; i++) {
+    energies.push_back(1*eV * std::pow(8., i / 99.));
+    values  .push_back(1.3 + 0.2 * std::sin(i / 7.));
+  }
+
+  auto plain = n4::material_properties().add("RINDEX", energies, values)               .done();
+  auto fast  = n4::material_properties().add("RINDEX", energies, values).fast_lookup().done();
+
+  // Same interpolation, whichever way the bin is found
+  for (auto i=0; i<1000; i++) {
+    auto e = energies.front() + (energies.back() - energies.front()) * i / 999.;
+    CHECK( fast -> GetProperty("RINDEX") -> Value(e) == plain -> GetProperty("RINDEX") -> Value(e) );
+  }
+}
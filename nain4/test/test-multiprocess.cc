@@ -0,0 +1,91 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+#include <n4-multiprocess.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace {
+
+auto water_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_WATER")).now(); }
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 10*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("multiprocess", "[multiprocess][nain]") {
+  auto path = (std::filesystem::temp_directory_path() / "n4-test-multiprocess.csv").string();
+  std::filesystem::remove(path);
+
+  // Reset at the start of each run, like most accumulators
+  size_t events = 0;
+  auto   file   = std::make_shared<std::ofstream>();
+
+  auto open  = [&] (G4Run const*) {
+    events = 0;
+    file -> open(n4::multiprocess::output_path(path));
+    *file << "event,random\n";
+  };
+  auto write = [&] (G4Event const* event) {
+    events++;
+    *file << n4::multiprocess::first_event() + event -> GetEventID() << ',' << G4UniformRand() << '\n';
+  };
+  auto close = [&] (G4Run const*) { file -> close(); };
+
+  n4::multiprocess::accumulator("events", events);
+  n4::multiprocess::output_file(path, 1);
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--processes", "3", "--seed", "1234", "-n", "10"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions([&] {
+        return (new n4::actions{electron_at_origin})
+          -> set((new n4::run_action  ) -> begin(open) -> end(close))
+          -> set((new n4::event_action) -> end(write));
+      })
+      .run();
+  }
+  n4::multiprocess::switch_off();
+
+  // Merged from the workers: the parent simulated no events itself
+  CHECK(events == 10);
+
+  // One header, then the events of all workers in order, each with its own random numbers
+  std::ifstream in{path};
+  std::string line;
+  REQUIRE(std::getline(in, line));
+  CHECK(line == "event,random");
+
+  std::set<std::string> randoms;
+  size_t n = 0;
+  while (std::getline(in, line)) {
+    auto comma = line.find(',');
+    CHECK(std::stoul(line.substr(0, comma)) == n);
+    randoms.insert(line.substr(comma + 1));
+    n++;
+  }
+  CHECK(n              == 10);
+  CHECK(randoms.size() == 10);
+  for (unsigned worker=0; worker<3; worker++) {
+    CHECK(! std::filesystem::exists(path + ".process-" + std::to_string(worker)));
+  }
+}
@@ -0,0 +1,122 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+#include <n4-material.hh>
+#include <n4-shape.hh>
+
+#include <G4Electron.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+
+namespace {
+
+// A scintillator whose photons are absorbed almost immediately, so that the
+// test is cheap
+G4PVPlacement* scintillator_in_air() {
+  auto energies = std::vector<G4double>{2*eV, 4*eV};
+  auto air = n4::material("G4_AIR");
+  auto scintillator = n4::material_from_elements_N("n4-test-scintillator", 1*g/cm3, {.state=kStateSolid},
+                                                   {{"C", 1}, {"H", 1}});
+  scintillator -> SetMaterialPropertiesTable(n4::material_properties()
+    .add("RINDEX"                    , energies, 1.5)
+    .add("ABSLENGTH"                 , energies, 1*um)
+    .add("SCINTILLATIONCOMPONENT1"   , energies, 1.0)
+    .add("SCINTILLATIONTIMECONSTANT1",           1*ns)
+    .add("SCINTILLATIONYIELD"        ,        1000/MeV)
+    .add("RESOLUTIONSCALE"           ,           1.0)
+    .done());
+
+  auto world = n4::box("world").cube(1*m).volume(air);
+  n4::box("scintillator").cube(50*cm).place(scintillator).in(world).now();
+  return n4::place(world).now();
+}
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 1*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("nain optical_stacking sample and defer", "[nain][optical_stacking]") {
+  auto stacking = (new n4::optical_stacking)
+    -> sample(0.25)
+    -> defer();
+
+  auto n_optical_stages = 0;
+  stacking -> optical_stage([&] (auto) { n_optical_stages++; });
+
+  auto weights_ok      = true;
+  auto optical_seen    = false;
+  auto others_after    = false;
+  auto counts          = std::vector<n4::optical_stacking::counts>{};
+  auto check_track = [&] (G4Track const* track) {
+    if (track -> GetDefinition() == G4OpticalPhoton::Definition()) {
+      optical_seen = true;
+      weights_ok  &= track -> GetWeight() == 4;
+    } else if (optical_seen) {
+      others_after = true;
+    }
+  };
+
+  auto actions = [&] {
+    return (new n4::actions{electron_at_origin})
+      -> set(stacking)
+      -> set((new n4::tracking_action) -> pre(check_track))
+      -> set((new n4::event_action) -> end([&] (auto) { counts.push_back(stacking -> this_event()); }));
+  };
+
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics(n4::test::default_physics_lists)
+     .geometry(scintillator_in_air)
+     .actions(actions)
+     .run(1);
+
+  REQUIRE(counts.size() == 1);
+  auto [created, dropped, deferred] = counts[0];
+  CHECK(created > 500);
+  CHECK(dropped + deferred == created);
+  CHECK(dropped > 0.65 * created);
+  CHECK(dropped < 0.85 * created);
+
+  // Every surviving photon was tracked after all other particles, in one
+  // extra stage, carrying a weight of 1/0.25
+  CHECK(n_optical_stages == 1);
+  CHECK(weights_ok);
+  CHECK(! others_after);
+}
+
+TEST_CASE("nain optical_stacking drop", "[nain][optical_stacking]") {
+  auto stacking     = (new n4::optical_stacking) -> drop();
+  auto optical_seen = false;
+  auto created      = size_t{0};
+
+  auto actions = [&] {
+    return (new n4::actions{electron_at_origin})
+      -> set(stacking)
+      -> set((new n4::tracking_action) -> pre([&] (auto track) {
+        optical_seen |= track -> GetDefinition() == G4OpticalPhoton::Definition();
+      }))
+      -> set((new n4::event_action) -> end([&] (auto) { created = stacking -> this_event().created; }));
+  };
+
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics(n4::test::default_physics_lists)
+     .geometry(scintillator_in_air)
+     .actions(actions)
+     .run(1);
+
+  CHECK(created > 500);
+  CHECK(stacking -> this_event().dropped == created);
+  CHECK(! optical_seen);
+}
@@ -0,0 +1,91 @@
+#include "testing.hh"
+
+#include <n4-overlaps.hh>
+#include <n4-shape.hh>
+
+#include <Randomize.hh>
+
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+TEST_CASE("nain overlaps clean geometry", "[nain][overlaps]") {
+  auto air   = n4::material("G4_AIR");
+  auto world = n4::box("world").cube(1*m).place(air).now();
+  n4::box("left" ).cube(10*cm).place(air).in(world).at_x(-20*cm).now();
+  n4::box("right").cube(10*cm).place(air).in(world).at_x( 20*cm).now();
+
+  auto threads  = GENERATE(1u, 4u);
+  auto overlaps = n4::overlap_check().points(2000).threads(threads).run(world);
+  CHECK(overlaps.empty());
+
+  std::ostringstream out;
+  CHECK(n4::report_overlaps(out, overlaps) == 0);
+}
+
+TEST_CASE("nain overlaps detected", "[nain][overlaps]") {
+  auto air    = n4::material("G4_AIR");
+  auto world  = n4::box("world").cube(1*m).place(air).now();
+  auto left   = n4::box("left"  ).cube(10*cm).place(air).in(world).at_x(-2*cm).now();
+  auto right  = n4::box("right" ).cube(10*cm).place(air).in(world).at_x( 6*cm).now();
+  auto sticky = n4::box("sticky").cube(10*cm).place(air).in(world).at_x(48*cm).now();
+
+  auto threads  = GENERATE(1u, 4u);
+  auto overlaps = n4::overlap_check().points(5000).threads(threads).run(world);
+
+  auto find = [&] (auto volume, auto other) {
+    return std::find_if(begin(overlaps), end(overlaps),
+                        [&] (auto& o) { return o.volume == volume && o.other == other; });
+  };
+
+  // left and right overlap by 2 cm, sticky protrudes from world by 3 cm
+  auto lr = find(left  , right);
+  auto rl = find(right , left );
+  auto sw = find(sticky, world);
+  REQUIRE(lr != end(overlaps));
+  REQUIRE(rl != end(overlaps));
+  REQUIRE(sw != end(overlaps));
+  CHECK(lr -> kind == n4::overlap::problem::overlap);
+  CHECK(sw -> kind == n4::overlap::problem::protrusion);
+  CHECK(lr -> depth <= 2*cm + 1e-9);
+  CHECK(sw -> depth <= 3*cm + 1e-9);
+  CHECK(sw -> depth >  2*cm);
+  CHECK(overlaps.size() == 3);
+
+  // Deepest first
+  CHECK(overlaps.front().volume == sticky);
+
+  // Overlaps smaller than the tolerance are ignored
+  auto tolerant = n4::overlap_check().points(5000).threads(threads).tolerance(5*cm).run(world);
+  CHECK(tolerant.empty());
+
+  std::ostringstream out;
+  CHECK(n4::report_overlaps(out, overlaps) == 3);
+}
+
+TEST_CASE("nain overlaps reproducible", "[nain][overlaps]") {
+  auto air   = n4::material("G4_AIR");
+  auto world = n4::box("world").cube(1*m).place(air).now();
+  n4::box ("left" ).cube(10*cm)     .place(air).in(world).at_x(-2*cm).now();
+  n4::tubs("right").r(5*cm).z(10*cm).place(air).in(world).at_x( 6*cm).now();
+  n4::box ("other").cube(10*cm)     .place(air).in(world).at_x(30*cm).now();
+  n4::tubs("stuck").r(5*cm).z(10*cm).place(air).in(world).at_x(33*cm).now();
+
+  auto threads = GENERATE(1u, 4u);
+  auto check = [&] {
+    G4Random::setTheSeed(1234);
+    return n4::overlap_check().points(500).threads(threads).run(world);
+  };
+
+  auto first  = check();
+  auto second = check();
+  REQUIRE(first.size() == 4);
+  REQUIRE(second.size() == first.size());
+  for (size_t i=0; i<first.size(); i++) {
+    CHECK(second[i].volume == first[i].volume);
+    CHECK(second[i].other  == first[i].other );
+    CHECK(second[i].depth  == first[i].depth );
+    CHECK(second[i].point  == first[i].point );
+  }
+}
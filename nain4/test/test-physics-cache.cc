@@ -0,0 +1,41 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-physics-cache.hh>
+#include <n4-run-manager.hh>
+
+#include <FTFP_BERT.hh>
+
+#include <filesystem>
+
+TEST_CASE("nain physics cache", "[nain][physics_cache]") {
+  auto dir = (std::filesystem::temp_directory_path() / "n4-test-physics-cache").string();
+  std::filesystem::remove_all(dir);
+
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics<FTFP_BERT>(0)
+     .geometry(n4::test::water_box)
+     .actions(n4::test::do_nothing)
+     .physics_cache(dir)
+     .run(0);
+
+  auto key   = n4::physics_cache::key();
+  auto entry = std::filesystem::path{dir} / ("physics-" + key);
+  CHECK(std::filesystem::is_directory(entry));
+  CHECK(std::filesystem::exists(entry / "n4-physics-cache-complete"));
+
+  // Nothing changed: same key, and the existing entry is used
+  CHECK(n4::physics_cache::key() == key);
+  n4::physics_cache::build(dir, n4::run_manager::get_ui());
+  auto entries = std::distance(std::filesystem::directory_iterator{dir}, std::filesystem::directory_iterator{});
+  CHECK(entries == 1);
+
+  // Tables depend on the materials
+  n4::material("G4_Pb");
+  CHECK(n4::physics_cache::key() != key);
+
+  std::filesystem::remove_all(dir);
+}
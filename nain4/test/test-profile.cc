@@ -0,0 +1,55 @@
+#include "testing.hh"
+
+#include <n4-boolean-shape.hh>
+#include <n4-profile.hh>
+
+#include <algorithm>
+#include <sstream>
+
+auto find_entry(const std::vector<n4::profile::entry>& entries, const std::string& phase, const std::string& name) {
+  return std::find_if(begin(entries), end(entries),
+                      [&] (auto& e) { return e.phase == phase && e.name == name; });
+}
+
+TEST_CASE("nain profile off", "[nain][profile]") {
+  n4::profile::switch_off();
+  n4::profile::reset();
+  auto air = n4::material("G4_AIR");
+  n4::box("box").cube(1*m).place(air).now();
+  CHECK(n4::profile::entries().empty());
+}
+
+TEST_CASE("nain profile geometry", "[nain][profile]") {
+  n4::profile::reset();
+  n4::profile::switch_on();
+
+  auto air   = n4::material("G4_AIR");
+  auto world = n4::box("world").cube(1*m).place(air).now();
+  for (auto i=0; i<3; i++) {
+    n4::box("cube").cube(1*cm).place(air).in(world).at_x(i*10*cm).copy_no(i).now();
+  }
+  n4::box("holed").cube(10*cm).subtract(n4::tubs("hole").r(1*cm).z(20*cm)).name("holed").volume(air);
+  { n4::profile::scope timer{"user", "custom"}; }
+  n4::profile::switch_off();
+
+  auto entries = n4::profile::entries();
+  auto cubes   = find_entry(entries, "shape::volume"       , "cube");
+  auto holed   = find_entry(entries, "boolean_shape::solid", "holed");
+  auto custom  = find_entry(entries, "user"                , "custom");
+  REQUIRE(cubes  != end(entries));
+  REQUIRE(holed  != end(entries));
+  REQUIRE(custom != end(entries));
+  CHECK(cubes  -> calls == 3);
+  CHECK(holed  -> calls == 1);
+  CHECK(find_entry(entries, "place::now", "cube-2") != end(entries));
+
+  // Sorted by decreasing time
+  CHECK(std::is_sorted(begin(entries), end(entries), [] (auto& a, auto& b) { return a.seconds > b.seconds; }));
+
+  std::ostringstream out;
+  n4::profile::report(out);
+  CHECK(out.str().find("boolean_shape::solid / holed") != std::string::npos);
+
+  n4::profile::reset();
+  CHECK(n4::profile::entries().empty());
+}
@@ -10,6 +10,7 @@
 #include <G4PVPlacement.hh>
 #include <G4RunManager.hh>
 #include <G4Trd.hh>
+#include <G4Tubs.hh>
 
 // Managers
 #include <G4NistManager.hh>
@@ -19,6 +20,9 @@
 #include <G4UnitsTable.hh>
 
 // Other G4
+#include <G4GeometryManager.hh>
+#include <G4Navigator.hh>
+#include <G4TransportationManager.hh>
 #include <G4Gamma.hh>
 #include <G4Material.hh>
 #include <G4VUserDetectorConstruction.hh>
@@ -384,3 +388,84 @@ TEST_CASE("run manager execute", "[run_manager][execute]") {
   CHECK(c==1);
   CHECK(d==1);
 }
+
+TEST_CASE("run manager modify geometry", "[run_manager][modify_geometry]") {
+  G4VPhysicalVolume* straw;
+  G4LogicalVolume*   world_logical;
+  auto geometry = [&] {
+    auto air   = n4::material("G4_AIR");
+    auto water = n4::material("G4_WATER");
+    auto world = n4::box("world").cube(1*m).place(air).now();
+    world_logical = world -> GetLogicalVolume();
+    straw = n4::tubs("straw").r(1*cm).z(50*cm).place(water).in(world).now();
+    n4::box("left" ).cube(5*cm).place(water).in(world).at_x(-30*cm).now();
+    n4::box("right").cube(5*cm).place(water).in(world).at_x( 30*cm).now();
+    return world;
+  };
+
+  auto hush = n4::silence{std::cout};
+  n4::run_manager::hot_swap_switch_on();
+  n4::run_manager::create()
+     .ui("progname", fake_argv.argc, fake_argv.argv, false)
+     .physics<FTFP_BERT>(0)
+     .geometry(geometry)
+     .actions(do_nothing)
+     .run(0);
+
+  auto geometry_manager = G4GeometryManager::GetInstance();
+  auto navigator        = G4TransportationManager::GetTransportationManager() -> GetNavigatorForTracking();
+  auto locate = [&] (G4ThreeVector p) { return navigator -> LocateGlobalPointAndSetup(p, nullptr, false, true); };
+
+  CHECK(geometry_manager -> IsGeometryClosed());
+  CHECK(locate({1.5*cm, 0, 0}) != straw);
+
+  auto tubs = dynamic_cast<G4Tubs*>(straw -> GetLogicalVolume() -> GetSolid());
+  n4::run_manager::get().modify_geometry({straw}, [&] {
+    tubs  -> SetOuterRadius(2*cm);
+    straw -> SetTranslation({0, 10*cm, 0});
+  });
+
+  CHECK(geometry_manager -> IsGeometryClosed());
+  CHECK(world_logical -> GetVoxelHeader() != nullptr);
+  CHECK(locate({1.5*cm, 10*cm, 0}) == straw);
+  CHECK(locate({1.5*cm,     0, 0}) != straw);
+
+  // Runs keep working on the modified geometry
+  CHECK(! n4::run_manager::get_ui().beam_on(1).has_value());
+}
+
+TEST_CASE("run manager actions built once per thread", "[run_manager][actions]") {
+  unsigned built = 0;
+  auto actions = [&built] { built++; return new n4::actions{do_nothing}; };
+
+  auto hush = n4::silence{std::cout};
+  auto rm = n4::run_manager::create()
+     .ui("progname", fake_argv.argc, fake_argv.argv, false)
+     .physics<FTFP_BERT>(0)
+     .geometry(water_box)
+     .actions(actions)
+     .run(1);
+  CHECK(built == 1);
+
+  // The sequential run manager has a single thread, which keeps its actions
+  rm -> replace_geometry(water_box).run(1);
+  CHECK(built == 1);
+}
+
+TEST_CASE("cli threads and seed", "[nain][cli]") {
+  auto hush = n4::silence{std::cout};
+  argcv a{"progname", "--threads", "4", "--seed", "1234"};
+  n4::ui ui{"automated-test", a.argc, a.argv, false};
+  CHECK(ui.threads() == 4);
+  CHECK(ui.seed   () == 1234);
+
+  argcv b{"progname"};
+  n4::ui sequential{"automated-test", b.argc, b.argv, false};
+  CHECK(! sequential.threads().has_value());
+  CHECK(! sequential.seed   ().has_value());
+
+  for (auto bad : {"abc", "12x", ""}) {
+    argcv c{"progname", "--seed", bad};
+    CHECK_THROWS_AS((n4::ui{"automated-test", c.argc, c.argv, false}), std::runtime_error);
+  }
+}
@@ -0,0 +1,61 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-scan.hh>
+
+#include <FTFP_BERT.hh>
+#include <G4Box.hh>
+#include <G4TransportationManager.hh>
+
+TEST_CASE("nain scan", "[nain][scan]") {
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics<FTFP_BERT>(0)
+     .geometry(n4::test::water_box)
+     .actions(n4::test::do_nothing)
+     .run(0);
+
+  auto box_size = [] (double side) {
+    auto water = n4::material("G4_WATER");
+    return n4::box("box").cube(side).place(water).now();
+  };
+
+  unsigned events      = 0;
+  unsigned geometries  = 0;
+  unsigned action_sets = 0;
+  std::vector<G4String> gun_energies;
+
+  auto actions = [&] (double) {
+    action_sets++;
+    events = 0;
+    return (new n4::actions{n4::test::do_nothing})
+      -> set((new n4::event_action) -> end([&] (auto) { events++; }));
+  };
+
+  auto rm      = &n4::run_manager::get();
+  auto sides   = std::vector<double>{1*m, 2*m, 3*m};
+  auto results = n4::scan<double, std::pair<unsigned, double>>()
+    .geometry([&] (double side) { geometries++; return box_size(side); })
+    .actions (actions)
+    .commands([] (double side) { return std::vector<std::string>{"/control/echo " + std::to_string(side)}; })
+    .events(3)
+    .result([&] (double) {
+      auto world = G4TransportationManager::GetTransportationManager()
+        -> GetNavigatorForTracking() -> GetWorldVolume();
+      auto box = dynamic_cast<G4Box*>(world -> GetLogicalVolume() -> GetSolid());
+      return std::pair{events, 2 * box -> GetXHalfLength()};
+    })
+    .run(sides);
+
+  // The geometry and actions are swapped without going through ready::run again
+  CHECK(&n4::run_manager::get() == rm);
+  CHECK(geometries  == 3);
+  CHECK(action_sets == 3);
+  REQUIRE(results.size() == sides.size());
+  for (size_t i=0; i<sides.size(); i++) {
+    CHECK     (results[i].first == 3);
+    CHECK_THAT(results[i].second / m, Within1ULP(sides[i] / m));
+  }
+}
@@ -1,5 +1,17 @@
 #include <n4-all.hh>
+
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Threading.hh>
+
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <mutex>
+#include <vector>
+
+using Catch::Matchers::WithinRel;
 
 TEST_CASE("nain find sensitive", "[nain][find][sensitive]") {
   auto dummy = [] (const G4Step*) {return true;};
@@ -16,3 +28,91 @@ TEST_CASE("nain find sensitive", "[nain][find][sensitive]") {
   auto should_not_exist = n4::find_sensitive<n4::sensitive_detector>("MISSING-NAME-92zidf");
   CHECK(! should_not_exist.has_value());
 }
+
+TEST_CASE("nain photodetector pde", "[nain][sensitive][photodetector]") {
+  auto energies = std::vector<G4double>{1., 2., 4., 5., 8.};
+  auto pdes     = std::vector<G4double>{0.1, 0.3, 0.2, 0.6, 0.4};
+  auto pd       = new n4::photodetector{"pd-curve", energies, pdes};
+
+  // Exact at the nodes, linear in between, zero outside the curve
+  for (size_t i=0; i<energies.size(); i++) { CHECK_THAT(pd -> pde(energies[i]), WithinRel(pdes[i], 1e-12)); }
+  CHECK_THAT(pd -> pde(1.5 ), WithinRel(0.2        , 1e-12));
+  CHECK_THAT(pd -> pde(3.  ), WithinRel(0.25       , 1e-12));
+  CHECK_THAT(pd -> pde(4.75), WithinRel(0.5        , 1e-12));
+  CHECK_THAT(pd -> pde(7.  ), WithinRel(0.4 + 0.2/3, 1e-12));
+  CHECK(pd -> pde(0.99) == 0);
+  CHECK(pd -> pde(8.01) == 0);
+}
+
+TEST_CASE("nain photodetector hits", "[nain][sensitive][photodetector]") {
+  auto hit_counts = std::vector<size_t>{};
+  auto copy_nos   = std::vector<G4int> {};
+
+  auto geometry = [&] {
+    auto air   = n4::material("G4_AIR");
+    auto world = n4::box("world").cube(1*m).volume(air);
+    auto pd    = (new n4::photodetector{"pd-hits", {0., 1*GeV}, {1., 1.}})
+      -> end_of_event([&] (auto const& hits) {
+        hit_counts.push_back(hits.size());
+        for (auto const& hit : hits) { copy_nos.push_back(hit.copy_no); }
+      });
+    n4::box("detector").cube(10*cm).sensitive(pd).place(air).in(world).at_x(30*cm).copy_no(3).now();
+    return n4::place(world).now();
+  };
+
+  auto geantino_along_x = [] (G4Event* event) {
+    auto vertex = new G4PrimaryVertex{};
+    vertex -> SetPrimary(new G4PrimaryParticle{n4::find_particle("geantino"), 1*MeV, 0, 0});
+    event  -> AddPrimaryVertex(vertex);
+  };
+
+  n4::test::argcv fake_argv{"progname"};
+  n4::run_manager::create()
+    .ui("progname", fake_argv.argc, fake_argv.argv, false)
+    .physics(n4::test::default_physics_lists)
+    .geometry(geometry)
+    .actions(new n4::actions{geantino_along_x})
+    .run(3);
+
+  // One geantino per event, stopped on entry and always detected; the
+  // buffer is emptied between events
+  CHECK(hit_counts == std::vector<size_t>{1, 1, 1});
+  CHECK(copy_nos   == std::vector<G4int> {3, 3, 3});
+}
+
+TEST_CASE("nain photodetector hits threads", "[nain][sensitive][photodetector]") {
+  std::mutex          mutex;
+  std::vector<size_t> hit_counts;
+  size_t              in_workers = 0;
+
+  auto geometry = [&] {
+    auto air   = n4::material("G4_AIR");
+    auto world = n4::box("world").cube(1*m).volume(air);
+    auto pd    = (new n4::photodetector{"pd-threads", {0., 1*GeV}, {1., 1.}})
+      -> end_of_event([&] (auto const& hits) {
+        std::lock_guard<std::mutex> lock{mutex};
+        hit_counts.push_back(hits.size());
+        if (G4Threading::IsWorkerThread()) { in_workers++; }
+      });
+    n4::box("detector").cube(10*cm).sensitive(pd).place(air).in(world).at_x(30*cm).now();
+    return n4::place(world).now();
+  };
+
+  auto geantino_along_x = [] (G4Event* event) {
+    auto vertex = new G4PrimaryVertex{};
+    vertex -> SetPrimary(new G4PrimaryParticle{n4::find_particle("geantino"), 1*MeV, 0, 0});
+    event  -> AddPrimaryVertex(vertex);
+  };
+
+  n4::test::argcv args{"progname", "--threads", "2"};
+  n4::run_manager::create()
+    .ui("progname", args.argc, args.argv, false)
+    .physics(n4::test::default_physics_lists)
+    .geometry(geometry)
+    .actions([&] { return new n4::actions{geantino_along_x}; })
+    .run(4);
+
+  // The geometry is built on the master: each worker needs its own detector
+  CHECK(hit_counts == std::vector<size_t>{1, 1, 1, 1});
+  CHECK(in_workers == 4);
+}
@@ -1,5 +1,15 @@
 #include "testing.hh"
 
+#include <n4-exceptions.hh>
+#include <n4-mesh.hh>
+
+#include <catch2/generators/catch_generators.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
 TEST_CASE("nain box", "[nain][box]") {
   // nain4::box is a more convenient interface for constructing G4VSolids and
   // G4LogicalVolumes based on G4Box
@@ -519,3 +529,124 @@ TEST_CASE("nain trd", "[nain][trd]") {
   check_dimensions(n4::trd("trd_xyz")     .     xy1(lxy1  ).     xy2(lxy2  ).z(lz).solid());
   check_dimensions(n4::trd("trd_half_xyz").half_xy1(lxy1/2).half_xy2(lxy2/2).z(lz).solid());
 }
+
+// Cube of side 1 with corner i at (i&1, i&2, i&4), faces anticlockwise from outside
+static const std::vector<std::array<int, 4>> cube_quads{{0,2,3,1}, {4,5,7,6}, {0,1,5,4},
+                                                        {2,6,7,3}, {0,4,6,2}, {1,3,7,5}};
+static std::array<float, 3> cube_corner(int i) { return {float(i & 1), float((i >> 1) & 1), float((i >> 2) & 1)}; }
+
+static std::string mesh_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / ("n4-test-" + name)).string();
+}
+
+static std::string write_ascii_stl(float l) {
+  auto path = mesh_path("cube-ascii.stl");
+  std::ofstream out{path};
+  out << "solid cube\n";
+  for (auto& q : cube_quads) {
+    for (auto tri : {std::array{q[0], q[1], q[2]}, std::array{q[0], q[2], q[3]}}) {
+      out << "  facet normal 0 0 0\n    outer loop\n";
+      for (auto i : tri) { auto [x, y, z] = cube_corner(i); out << "      vertex " << x*l << ' ' << y*l << ' ' << z*l << '\n'; }
+      out << "    endloop\n  endfacet\n";
+    }
+  }
+  out << "endsolid cube\n";
+  return path;
+}
+
+static std::string write_binary_stl(float l) {
+  auto path = mesh_path("cube-binary.stl");
+  std::ofstream out{path, std::ios::binary};
+  char header[80] = "solid but actually binary";
+  uint32_t n = 12;
+  uint16_t attribute = 0;
+  out.write(header, 80);
+  out.write(reinterpret_cast<char*>(&n), sizeof(n));
+  for (auto& q : cube_quads) {
+    for (auto tri : {std::array{q[0], q[1], q[2]}, std::array{q[0], q[2], q[3]}}) {
+      float normal[3] = {0, 0, 0};
+      out.write(reinterpret_cast<char*>(normal), sizeof(normal));
+      for (auto i : tri) {
+        auto [x, y, z] = cube_corner(i);
+        float v[3] = {x*l, y*l, z*l};
+        out.write(reinterpret_cast<char*>(v), sizeof(v));
+      }
+      out.write(reinterpret_cast<char*>(&attribute), sizeof(attribute));
+    }
+  }
+  return path;
+}
+
+static std::string write_obj(float l) {
+  auto path = mesh_path("cube.obj");
+  std::ofstream out{path};
+  out << "# cube\no cube\n";
+  for (auto i=0; i<8; i++) { auto [x, y, z] = cube_corner(i); out << "v " << x*l << ' ' << y*l << ' ' << z*l << '\n'; }
+  out << "vn 0 0 1\n";
+  for (auto& q : cube_quads) { out << "f " << q[0]+1 << "//1 " << q[1]+1 << "//1 " << q[2]+1 << "//1 " << q[3]+1 << "//1\n"; }
+  return path;
+}
+
+TEST_CASE("nain mesh readers", "[nain][mesh]") {
+  auto l    = 10.f;
+  auto path = GENERATE_REF(write_ascii_stl(l), write_binary_stl(l), write_obj(l));
+  auto mesh = n4::read_mesh(path, cm);
+
+  // Shared corners are merged
+  CHECK(mesh.vertices .size() ==  8);
+  CHECK(mesh.triangles.size() == 12);
+  for (auto& v : mesh.vertices) {
+    for (auto c : {v.x(), v.y(), v.z()}) { CHECK((c == 0 || c == l*cm)); }
+  }
+}
+
+TEST_CASE("nain mesh errors", "[nain][mesh]") {
+  auto garbage = mesh_path("garbage.stl");
+  std::ofstream{garbage} << "this is not a mesh";
+  CHECK_THROWS_AS(n4::read_mesh(garbage)                 , n4::exceptions::parse_error);
+  CHECK_THROWS_AS(n4::read_mesh(mesh_path("missing.obj")), n4::exceptions::not_found);
+  CHECK_THROWS_AS(n4::read_mesh(mesh_path("cube.ply"))   , n4::exceptions::parse_error);
+}
+
+TEST_CASE("nain tessellated", "[nain][tessellated]") {
+  auto water = n4::material("G4_WATER");
+  auto l     = 10.f;
+  auto path  = GENERATE_REF(write_ascii_stl(l), write_binary_stl(l), write_obj(l));
+
+  auto from_file = n4::tessellated("from_file").file(path).unit(cm).volume(water);
+  auto from_mesh = n4::tessellated("from_mesh").mesh(n4::read_mesh(path, cm)).solid();
+
+  auto solid = from_file -> GetSolid();
+  CHECK(solid -> GetName() == "from_file");
+  CHECK(dynamic_cast<G4TessellatedSolid*>(solid) -> GetSolidClosed());
+  CHECK(from_mesh -> GetNumberOfFacets() == 12);
+
+  auto side = l * cm;
+  for (auto s : {solid, static_cast<G4VSolid*>(from_mesh)}) {
+    CHECK_THAT(s -> GetCubicVolume() / m3, WithinRel(side*side*side / m3, 1e-6));
+    CHECK(s -> Inside({side/2, side/2, side/2}) == kInside );
+    CHECK(s -> Inside({side*2, side/2, side/2}) == kOutside);
+  }
+}
+
+TEST_CASE("nain extruded", "[nain][extruded]") {
+  auto l  = 1*m;
+  auto lz = 3*m;
+  std::vector<G4TwoVector> square{{-l/2, -l/2}, {-l/2, l/2}, {l/2, l/2}, {l/2, -l/2}};
+
+  auto prism = n4::extruded("prism").polygon(square).z(lz).solid();
+  CHECK     (prism -> GetName() == "prism");
+  CHECK_THAT(prism -> GetCubicVolume() / m3, WithinRel(l * l * lz / m3, 1e-6));
+  CHECK     (prism -> GetNofZSections() == 2);
+  CHECK_THAT(prism -> GetZSection(1).fZ / m, Within1ULP(lz / 2 / m));
+
+  // Sections may be given in any order: frustum of a square pyramid
+  auto frustum = n4::extruded("frustum").polygon(square)
+    .section( lz/2, {}, 0.5)
+    .section(-lz/2, {}, 1  )
+    .solid();
+  auto a1 = l * l, a2 = l * l / 4;
+  CHECK_THAT(frustum -> GetCubicVolume() / m3, WithinRel(lz / 3 * (a1 + a2 + std::sqrt(a1 * a2)) / m3, 1e-6));
+  CHECK(frustum -> Inside({0.4*l, 0, -lz/2 + 1*cm}) == kInside );
+  CHECK(frustum -> Inside({0.4*l, 0,  lz/2 - 1*cm}) == kOutside);
+}
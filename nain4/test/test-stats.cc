@@ -150,3 +150,44 @@ TEST_CASE("stats min_max", "[stats][min_max]") {
   unordered_set<int> b {6,5,4,3};
   check_min_max(b, 3, 6);
 }
+
+TEST_CASE("stats running", "[stats][running]") {
+  running empty;
+  CHECK(empty.count() == 0);
+  CHECK(! empty.mean          ().has_value());
+  CHECK(! empty.std_dev_sample().has_value());
+  CHECK(! empty.std_error     ().has_value());
+
+  running one;
+  one.add(2.3);
+  CHECK_THAT(one.mean().value(), Within1ULP(2.3));
+  CHECK_THAT(one.std_dev_population().value(), Within1ULP(0.0));
+  CHECK(! one.std_dev_sample().has_value());
+
+  // Agrees with the container versions
+  auto data = vector<double>{1.5, 3.25, -2.0, 8.0, 0.5, 4.75};
+  running all;
+  for (auto x : data) { all.add(x); }
+  CHECK(all.count() == data.size());
+  CHECK_THAT(all.mean               ().value(), WithinRel(mean               (data).value(), 1e-12));
+  CHECK_THAT(all.std_dev_population ().value(), WithinRel(std_dev_population (data).value(), 1e-12));
+  CHECK_THAT(all.std_dev_sample     ().value(), WithinRel(std_dev_sample     (data).value(), 1e-12));
+  CHECK_THAT(all.std_error          ().value(), WithinRel(std_dev_sample     (data).value() / sqrt(data.size()), 1e-12));
+  CHECK_THAT(all.relative_error     ().value(), WithinRel(all.std_error().value() / all.mean().value(), 1e-12));
+
+  // Merging the stats of two halves gives the stats of the whole
+  running first, second;
+  for (size_t i=0; i<3          ; i++) { first .add(data[i]); }
+  for (size_t i=3; i<data.size(); i++) { second.add(data[i]); }
+  first.merge(second);
+  first.merge(running{});
+  CHECK(first.count() == data.size());
+  CHECK_THAT(first.mean          ().value(), WithinRel(all.mean          ().value(), 1e-12));
+  CHECK_THAT(first.std_dev_sample().value(), WithinRel(all.std_dev_sample().value(), 1e-12));
+
+  // Relative error is undefined when the mean is zero
+  running zero;
+  zero.add(-1);
+  zero.add( 1);
+  CHECK(! zero.relative_error().has_value());
+}
@@ -0,0 +1,83 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+namespace {
+
+auto water_with_lead() {
+  auto world = n4::box("world").cube(1*m).volume(n4::material("G4_WATER"));
+  n4::box("lead").cube(10*cm).place(n4::material("G4_Pb")).in(world).at_x(20*cm).now();
+  return n4::place(world).now();
+}
+
+void electron_along_x(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 100*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("nain step_profiler", "[nain][step_profiler]") {
+  auto dump     = (std::filesystem::temp_directory_path() / "n4-test-step-profiler.csv").string();
+  auto n_steps  = size_t{0};
+  auto n_events = 2;
+  std::filesystem::remove(dump);
+
+  auto profiler = (new n4::step_profiler{new n4::stepping_action{[&] (auto) { n_steps++; }}})
+    -> dump(dump);
+
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics(n4::test::default_physics_lists)
+     .geometry(water_with_lead)
+     .actions([&] { return (new n4::actions{electron_along_x}) -> set(profiler); })
+     .run(n_events);
+
+  auto buckets = profiler -> buckets();
+  auto profiled_steps = std::accumulate(begin(buckets), end(buckets), size_t{0},
+                                        [] (auto sum, auto& b) { return sum + b.steps; });
+  auto seconds        = std::accumulate(begin(buckets), end(buckets), 0.0,
+                                        [] (auto sum, auto& b) { return sum + b.seconds; });
+
+  // The wrapped action still sees every step; the first step of each primary is not profiled
+  CHECK(n_steps        >  0);
+  CHECK(profiled_steps == n_steps - n_events);
+  CHECK(seconds        >  0);
+  CHECK(std::is_sorted(begin(buckets), end(buckets), [] (auto& a, auto& b) { return a.seconds > b.seconds; }));
+
+  auto has = [&] (auto field, std::string const& value) {
+    return std::any_of(begin(buckets), end(buckets), [&] (auto& b) { return b.*field == value; });
+  };
+  CHECK(has(&n4::step_profiler::bucket::volume  , "world"));
+  CHECK(has(&n4::step_profiler::bucket::volume  , "lead" ));
+  CHECK(has(&n4::step_profiler::bucket::particle, "e-"   ));
+  CHECK(has(&n4::step_profiler::bucket::particle, "gamma"));
+  CHECK(has(&n4::step_profiler::bucket::process , "eIoni"));
+
+  // One CSV line per bucket, after the header
+  REQUIRE(std::filesystem::exists(dump));
+  std::ifstream in{dump};
+  std::string header;
+  std::getline(in, header);
+  CHECK(header == "volume,particle,process,steps,seconds");
+  auto lines = size_t{0};
+  for (std::string line; std::getline(in, line); ) { lines++; }
+  CHECK(lines == buckets.size());
+
+  std::filesystem::remove(dump);
+}
@@ -0,0 +1,180 @@
+#include "testing.hh"
+
+#include <n4-checkpoint.hh>
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+#include <n4-material.hh>
+#include <n4-photodetector.hh>
+#include <n4-shape.hh>
+#include <n4-sub-events.hh>
+
+#include <G4Electron.hh>
+#include <G4EventManager.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4VPhysicalVolume.hh>
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <vector>
+
+namespace {
+
+G4Material* scintillator(G4double absorption_length) {
+  auto energies = std::vector<G4double>{2*eV, 4*eV};
+  auto scintillator = n4::material_from_elements_N("n4-test-scintillator", 1*g/cm3, {.state=kStateSolid},
+                                                   {{"C", 1}, {"H", 1}});
+  scintillator -> SetMaterialPropertiesTable(n4::material_properties()
+    .add("RINDEX"                    , energies, 1.5)
+    .add("ABSLENGTH"                 , energies, absorption_length)
+    .add("SCINTILLATIONCOMPONENT1"   , energies, 1.0)
+    .add("SCINTILLATIONTIMECONSTANT1",           1*ns)
+    .add("SCINTILLATIONYIELD"        ,        1000/MeV)
+    .add("RESOLUTIONSCALE"           ,           1.0)
+    .done());
+  return scintillator;
+}
+
+// A scintillator whose photons are absorbed almost immediately, so that the
+// test is cheap
+G4PVPlacement* scintillator_in_air() {
+  auto world = n4::box("world").cube(1*m).volume(n4::material("G4_AIR"));
+  n4::box("scintillator").cube(50*cm).place(scintillator(1*um)).in(world).now();
+  return n4::place(world).now();
+}
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 1*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("nain sub_events", "[nain][sub_events]") {
+  std::atomic<size_t> photons_in_events{0}, photons_in_sub_events{0}, electrons_in_sub_events{0};
+  std::mutex       mutex;
+  std::set<size_t> done;
+
+  auto count_track = [&] (G4Track const* track) {
+    auto event   = G4EventManager::GetEventManager() -> GetConstCurrentEvent();
+    auto optical = track -> GetDefinition() == G4OpticalPhoton::Definition();
+    if (! n4::sub_events::is_sub_event(event)) { if (optical) { photons_in_events++; } return; }
+    if (optical) { photons_in_sub_events++; } else { electrons_in_sub_events++; }
+  };
+
+  n4::sub_events::on_done([&] (size_t event) {
+    std::lock_guard<std::mutex> lock{mutex};
+    done.insert(event);
+  });
+
+  auto actions = [&] {
+    return (new n4::actions{electron_at_origin})
+      -> set((new n4::tracking_action) -> pre(count_track));
+  };
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--threads", "2", "--sub-events", "4", "-n", "3"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(scintillator_in_air)
+      .actions(actions)
+      .run();
+  }
+  n4::sub_events::switch_off();
+
+  // Every photon was taken off the stack of its event, and tracked in a sub-event
+  CHECK(photons_in_events       == 0);
+  CHECK(photons_in_sub_events   >  0);
+  CHECK(electrons_in_sub_events == 0);
+  // Each event is reported once, after all its sub-events
+  CHECK(done == std::set<size_t>{0, 1, 2});
+}
+
+TEST_CASE("nain sub_events photodetector", "[nain][sub_events][photodetector]") {
+  std::atomic<size_t> photons_detected{0};
+  std::mutex          mutex;
+  std::vector<size_t> hits_per_event;
+
+  // A small scintillator inside a photodetector which detects every photon
+  // leaving it
+  auto geometry = [&] {
+    auto energies = std::vector<G4double>{2*eV, 4*eV};
+    auto clear = n4::material_from_elements_N("n4-test-clear", 1*mg/cm3, {.state=kStateGas}, {{"N", 1}});
+    clear -> SetMaterialPropertiesTable(n4::material_properties().add("RINDEX", energies, 1.0).done());
+
+    auto pd = (new n4::photodetector{"sub-events-pd", {1*eV, 5*eV}, {1., 1.}})
+      -> end_of_event([&] (auto const& hits) {
+        std::lock_guard<std::mutex> lock{mutex};
+        hits_per_event.push_back(hits.size());
+      });
+    auto world    = n4::box("world"   ).cube( 1*m ).volume(n4::material("G4_AIR"));
+    auto detector = n4::box("detector").cube(20*cm).sensitive(pd).volume(clear);
+    n4::place(detector).in(world).now();
+    n4::box("scintillator").cube(1*cm).place(scintillator(1*m)).in(detector).now();
+    return n4::place(world).now();
+  };
+
+  auto count_detected = [&] (G4Step const* step) {
+    auto pre = step -> GetPreStepPoint();
+    if (step -> GetTrack() -> GetDefinition() == G4OpticalPhoton::Definition() &&
+        pre -> GetPhysicalVolume() -> GetName() == "detector") { photons_detected++; }
+  };
+
+  auto actions = [&] {
+    return (new n4::actions{electron_at_origin})
+      -> set(new n4::stepping_action{count_detected});
+  };
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--threads", "2", "--sub-events", "3", "-n", "3"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(geometry)
+      .actions(actions)
+      .run();
+  }
+  n4::sub_events::switch_off();
+
+  // One call per requested event, with the hits of all its parts, whichever
+  // threads they were simulated in
+  auto hits = std::accumulate(begin(hits_per_event), end(hits_per_event), size_t{0});
+  CHECK(hits_per_event.size() == 3);
+  CHECK(photons_detected      >  0);
+  CHECK(hits                  == photons_detected);
+}
+
+TEST_CASE("nain sub_events checkpoint", "[nain][sub_events][checkpoint]") {
+  auto dir = std::filesystem::temp_directory_path() / "n4-test-sub-events-checkpoint";
+  std::filesystem::remove_all(dir);
+
+  // Requested events, like checkpoint::events_done
+  std::vector<size_t> done;
+  n4::sub_events::on_done([&] (size_t event) { done.push_back(n4::checkpoint::events_done() + event); });
+
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname", "--sub-events", "2", "--checkpoint", dir.c_str(), "--chunk-size", "2", "-n", "5"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(scintillator_in_air)
+      .actions([] { return new n4::actions{electron_at_origin}; })
+      .run();
+  }
+  n4::sub_events::switch_off();
+  n4::checkpoint::switch_off();
+  std::filesystem::remove_all(dir);
+
+  CHECK(done == std::vector<size_t>{0, 1, 2, 3, 4});
+}
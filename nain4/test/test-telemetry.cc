@@ -0,0 +1,79 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+#include <n4-telemetry.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto water_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_WATER")).now(); }
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 10*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+} // namespace
+
+TEST_CASE("nain telemetry", "[nain][telemetry]") {
+  auto json = (std::filesystem::temp_directory_path() / "n4-test-telemetry.jsonl").string();
+  std::filesystem::remove(json);
+
+  n4::telemetry::switch_on();
+  n4::telemetry::progress_every(5);
+  n4::telemetry::json_lines(json);
+
+  std::ostringstream out;
+  n4::run_manager* rm;
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname"};
+    rm = n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions(electron_at_origin) // no run or event actions given
+      .run(10);
+  }
+  n4::telemetry::progress_every(0);
+  n4::telemetry::json_lines_off();
+
+  auto stats = rm -> telemetry();
+  CHECK(stats.events_requested  == 10);
+  CHECK(stats.events            == 10);
+  CHECK(stats.seconds           >  0);
+  CHECK(stats.events_per_second >  0);
+  CHECK(stats.latency_max       >  0);
+  CHECK(stats.latency_p50       <= stats.latency_p99);
+  CHECK(stats.latency_p99       <= stats.latency_max);
+  CHECK(stats.latency_mean      <= stats.latency_max);
+  CHECK(stats.latency_mean * stats.events <= stats.seconds);
+  CHECK(stats.peak_rss_bytes    >  0);
+
+  REQUIRE(n4::telemetry::last_run().has_value());
+  CHECK(n4::telemetry::last_run() -> events == 10);
+
+  std::ifstream in{json};
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);) { lines.push_back(line); }
+  REQUIRE(lines.size() == 3); // progress at 5 and 10 events, then the run
+  CHECK(lines[0].starts_with(R"({"type":"progress","events":5,)"));
+  CHECK(lines[1].starts_with(R"({"type":"progress","events":10,)"));
+  CHECK(lines[2].starts_with(R"({"type":"run","events_requested":10,"events":10,)"));
+  std::filesystem::remove(json);
+
+  n4::telemetry::report(out, stats);
+  CHECK(out.str().find("10 events") != std::string::npos);
+}
@@ -0,0 +1,84 @@
+#include "testing.hh"
+
+#include <n4-defaults.hh>
+#include <n4-main.hh>
+#include <n4-track-stats.hh>
+
+#include <G4Electron.hh>
+#include <G4PrimaryParticle.hh>
+#include <G4PrimaryVertex.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+auto water_cube() { return n4::box("world").cube(1*m).place(n4::material("G4_WATER")).now(); }
+
+void electron_at_origin(G4Event* event) {
+  auto vertex = new G4PrimaryVertex{};
+  vertex -> SetPrimary(new G4PrimaryParticle{G4Electron::Definition(), 50*MeV, 0, 0});
+  event  -> AddPrimaryVertex(vertex);
+}
+
+auto find_species(n4::track_stats::summary const& stats, std::string const& name) {
+  return std::find_if(begin(stats.by_species), end(stats.by_species),
+                      [&] (auto& s) { return s.particle == name; });
+}
+
+} // namespace
+
+TEST_CASE("nain track_stats off", "[nain][track_stats]") {
+  n4::track_stats::switch_off();
+  n4::track_stats::reset();
+
+  auto hush = n4::silence{std::cout};
+  n4::test::argcv args{"progname"};
+  n4::run_manager::create()
+     .ui("progname", args.argc, args.argv, false)
+     .physics(n4::test::default_physics_lists)
+     .geometry(water_cube)
+     .actions(electron_at_origin)
+     .run(1);
+
+  auto stats = n4::track_stats::collect();
+  CHECK(stats.events == 0);
+  CHECK(stats.by_species.empty());
+}
+
+TEST_CASE("nain track_stats shower", "[nain][track_stats]") {
+  n4::track_stats::switch_on();
+
+  std::ostringstream out;
+  {
+    auto hush = n4::silence{std::cout};
+    n4::test::argcv args{"progname"};
+    n4::run_manager::create()
+      .ui("progname", args.argc, args.argv, false)
+      .physics(n4::test::default_physics_lists)
+      .geometry(water_cube)
+      .actions(electron_at_origin) // no stacking, tracking or run actions given
+      .run(3);
+  }
+  n4::track_stats::switch_off();
+
+  auto stats = n4::track_stats::collect();
+  CHECK(stats.events == 3);
+  CHECK(stats.peak_stack_depth >= 1);
+  CHECK(stats.mean_peak_stack_depth <= stats.peak_stack_depth);
+
+  auto electrons = find_species(stats, "e-");
+  auto gammas    = find_species(stats, "gamma");
+  REQUIRE(electrons != end(stats.by_species));
+  REQUIRE(gammas    != end(stats.by_species));
+  // Nothing is killed or deferred by the default stacking action
+  CHECK(electrons -> tracked == electrons -> urgent);
+  CHECK(gammas    -> tracked == gammas    -> urgent);
+  CHECK(electrons -> urgent  >= 3);
+  CHECK(gammas    -> urgent  >  0);
+  CHECK(electrons -> seconds >  0);
+
+  n4::track_stats::report(out);
+  CHECK(out.str().find("3 events") != std::string::npos);
+}